@@ -14,9 +14,11 @@
 #include <libunicode/capi.h>
 #include <libunicode/convert.h>
 #include <libunicode/grapheme_segmenter.h>
+#include <libunicode/scan.h>
 #include <libunicode/ucd.h>
 #include <libunicode/width.h>
 
+#include <algorithm>
 #include <iterator>
 #include <string_view>
 
@@ -37,34 +39,59 @@ int u32_gc_count(u32_char_t const* codepoints, size_t size)
 
 int u8_gc_count(u8_char_t const* codepoints, size_t size)
 {
-    auto const u32 = unicode::convert_to<char32_t>(std::string_view(codepoints, size));
-    return u32_gc_count((uint32_t const*) u32.data(), u32.size());
+    return static_cast<int>(unicode::detail::measure_utf8_text(std::string_view(codepoints, size), false).clusterCount);
+}
+
+void u8_gc_count_batch(u8_char_t const* const* strings, size_t const* sizes, size_t count, int* results)
+{
+    for (size_t i = 0; i < count; ++i)
+        results[i] = u8_gc_count(strings[i], sizes[i]);
 }
 
 int u32_gc_width(u32_char_t const* codepoints, size_t size, int mode)
 {
-    auto const text = std::u32string_view(reinterpret_cast<char32_t const*>(codepoints), size);
+    // Segments and measures in the same pass, so each codepoint's properties are looked up once.
     auto totalWidth = 0;
-    auto segmenter = unicode::grapheme_segmenter(text);
-    auto processCluster = [&](std::u32string_view cluster) {
-        if (mode == GC_WIDTH_MODE_NON_MODIFIABLE)
-            totalWidth += static_cast<int>(unicode::width(cluster.front()));
-        else
-            totalWidth += static_cast<int>(unicode::grapheme_cluster_width(cluster));
-    };
-    processCluster(*segmenter);
-    while (segmenter.codepointsAvailable())
+    auto state = unicode::grapheme_segmenter_state {};
+    auto cluster = unicode::grapheme_cluster_width_accumulator {};
+    for (size_t i = 0; i < size; ++i)
     {
-        ++segmenter;
-        processCluster(*segmenter);
+        auto const codepoint = static_cast<char32_t>(codepoints[i]);
+        auto const properties = unicode::codepoint_properties::get(codepoint);
+        auto const breakable = [&] {
+            if (i == 0)
+            {
+                unicode::grapheme_process_init(codepoint, properties, state);
+                return true;
+            }
+            return unicode::grapheme_process_breakable(codepoint, properties, state);
+        }();
+        if (mode == GC_WIDTH_MODE_NON_MODIFIABLE)
+        {
+            if (breakable)
+                totalWidth += static_cast<int>(properties.char_width);
+            continue;
+        }
+        if (breakable)
+        {
+            totalWidth += static_cast<int>(cluster.width());
+            cluster.reset();
+        }
+        cluster.push(codepoint, properties);
     }
-    return totalWidth;
+    return totalWidth + static_cast<int>(cluster.width());
 }
 
 int u8_gc_width(u8_char_t const* codepoints, size_t count, int mode)
 {
-    auto const u32 = unicode::convert_to<char32_t>(std::string_view(codepoints, count));
-    return u32_gc_width(reinterpret_cast<u32_char_t const*>(u32.data()), u32.size(), mode);
+    auto const baseWidthOnly = mode == GC_WIDTH_MODE_NON_MODIFIABLE;
+    return static_cast<int>(unicode::detail::measure_utf8_text(std::string_view(codepoints, count), baseWidthOnly).width);
+}
+
+void u8_gc_width_batch(u8_char_t const* const* strings, size_t const* sizes, size_t count, int mode, int* results)
+{
+    for (size_t i = 0; i < count; ++i)
+        results[i] = u8_gc_width(strings[i], sizes[i], mode);
 }
 
 int u32_grapheme_unbreakable(u32_char_t a, u32_char_t b)
@@ -103,22 +130,65 @@ void u8u32_stream_convert_destroy(u8u32_stream_state_t* handle)
 int u32u8_convert(u32_char_t const* source, size_t slen, u8_char_t* dest, size_t dlen)
 {
     auto conv = unicode::encoder<u8_char_t> {};
-    auto nwritten = 0;
+    auto const destBegin = dest;
+    auto const destEnd = dest + dlen;
 
-    for (size_t i = 0; i < slen; ++i)
+    for (size_t i = 0; i < slen;)
     {
+        // US-ASCII shortcut: copy the run directly, as far as the destination allows.
+        if (source[i] < 0x80)
+        {
+            auto const run = std::min(slen - i, static_cast<size_t>(destEnd - dest));
+            auto k = size_t { 0 };
+            for (; k < run && source[i + k] < 0x80; ++k)
+                dest[k] = static_cast<u8_char_t>(source[i + k]);
+            if (k == 0)
+                return -1;
+            dest += k;
+            i += k;
+            continue;
+        }
+
         u8_char_t buf[4];
-        auto const bufEnd = conv(source[i], buf);
+        auto const bufEnd = conv(static_cast<char32_t>(source[i]), buf);
         auto const bufLength = static_cast<size_t>(std::distance(buf, bufEnd));
-        if (!(bufLength < dlen))
+        if (bufLength > static_cast<size_t>(destEnd - dest))
             return -1;
 
-        for (size_t k = 0; k < bufLength; ++k)
-            dest[k] = buf[k];
-        nwritten += static_cast<int>(bufLength);
-        dest += bufLength;
-        dlen -= bufLength;
+        dest = std::copy(buf, bufEnd, dest);
+        ++i;
     }
 
-    return nwritten;
+    return static_cast<int>(dest - destBegin);
+}
+
+struct u8_scan_state
+{
+    unicode::scan_state state {};
+};
+
+u8_scan_state_t u8_scan_state_create()
+{
+    return new u8_scan_state();
+}
+
+void u8_scan_state_reset(u8_scan_state_t handle)
+{
+    handle->state = {};
+}
+
+void u8_scan_state_destroy(u8_scan_state_t* handle)
+{
+    delete *handle;
+    *handle = nullptr;
+}
+
+u8_scan_result_t u8_scan_text(u8_scan_state_t handle, u8_char_t const* text, size_t n, size_t max_columns)
+{
+    // Every call scans a buffer of its own, so the resume position must not carry over from the last one.
+    handle->state.next = nullptr;
+    auto const result = unicode::scan_text(handle->state, std::string_view(text, n), max_columns);
+    auto const consumed = handle->state.next ? static_cast<size_t>(handle->state.next - text) : 0;
+    auto const textEnd = result.end > text ? static_cast<size_t>(result.end - text) : 0;
+    return u8_scan_result_t { result.count, consumed, textEnd };
 }
@@ -92,8 +92,25 @@ extern "C"
      *         in [codepoints, codepoints+n).
      */
     int u32_gc_count(u32_char_t const* codepoints, size_t n);
+
+    /**
+     * UTF-8 version of @c u32_gc_count().
+     *
+     * The UTF-8 bytes are segmented directly, without converting them first.
+     * Invalid UTF-8 sequences are counted as U+FFFD.
+     */
     int u8_gc_count(u8_char_t const* codepoints, size_t n);
 
+    /**
+     * Counts the grapheme clusters of @p count UTF-8 strings in one call.
+     *
+     * @param strings  pointers to the first byte of each string.
+     * @param sizes    number of bytes of each string.
+     * @param count    number of strings.
+     * @param results  receives @c u8_gc_count() of each string; must hold @p count elements.
+     */
+    void u8_gc_count_batch(u8_char_t const* const* strings, size_t const* sizes, size_t count, int* results);
+
 /**
  * Measures every grapheme cluster by its BASE CODEPOINT ALONE.
  *
@@ -139,10 +156,24 @@ extern "C"
     /**
      * UTF-8 version of @c u32_gc_width().
      *
+     * The UTF-8 bytes are measured directly, without converting them first.
+     * Invalid UTF-8 sequences are measured as U+FFFD.
+     *
      * @see u32_gc_width(u32_char_t const* codepoints, size_t n, int allowMod)
      */
     int u8_gc_width(u8_char_t const* codepoints, size_t n, int allowMod);
 
+    /**
+     * Computes the display width of @p count UTF-8 strings in one call.
+     *
+     * @param strings  pointers to the first byte of each string.
+     * @param sizes    number of bytes of each string.
+     * @param count    number of strings.
+     * @param mode     see @c u32_gc_width().
+     * @param results  receives @c u8_gc_width() of each string; must hold @p count elements.
+     */
+    void u8_gc_width_batch(u8_char_t const* const* strings, size_t const* sizes, size_t count, int mode, int* results);
+
     /**
      * Tests if two consecutive codepoints do belong to the same grapheme cluster,
      * i.e. are unbreakable and thus should not be broken up.
@@ -206,6 +237,8 @@ extern "C"
      * @param dest   Destination address where to store the converted UTF-8 sequence to.
      * @param dlen   Number of bytes to write to @p _dest at most.
      *
+     * No allocation takes place; US-ASCII runs are copied directly.
+     *
      * @note No trailing zero byte will be written.
      *
      * @retval >0     Success. TRhe number of bytes written to @p _dest is returned.
@@ -215,6 +248,58 @@ extern "C"
      */
     int u32u8_convert(u32_char_t const* source, size_t slen, u8_char_t* dest, size_t dlen);
 
+    /**
+     * Opaque handle for the state kept across consecutive calls to @c u8_scan_text().
+     */
+    struct u8_scan_state;
+    typedef struct u8_scan_state* u8_scan_state_t;
+
+    /**
+     * Result of a call to @c u8_scan_text().
+     */
+    typedef struct u8_scan_result
+    {
+        /// Number of columns the scanned text occupies.
+        size_t columns;
+
+        /// Number of input bytes consumed. The next call continues behind them.
+        size_t consumed;
+
+        /// Number of input bytes, counted from the start of the input, that complete the scanned text.
+        /// Any bytes in [text_end, consumed) begin a UTF-8 sequence left incomplete at the end of the input.
+        size_t text_end;
+    } u8_scan_result_t;
+
+    /**
+     * Constructs the state for a sequence of calls to @c u8_scan_text().
+     */
+    u8_scan_state_t u8_scan_state_create();
+
+    /**
+     * Resets the state, e.g. after the caller processed a control character.
+     */
+    void u8_scan_state_reset(u8_scan_state_t handle);
+
+    /**
+     * Destroys the scan state.
+     * The parameter @p handle will be set to NULL when this call leaves.
+     */
+    void u8_scan_state_destroy(u8_scan_state_t* handle);
+
+    /**
+     * Scans UTF-8 text for as many grapheme clusters as fit into @p max_columns.
+     *
+     * This is the C binding of unicode::scan_text(). The scan stops early at a control character,
+     * and a grapheme cluster or UTF-8 sequence split across two calls is continued by the next call
+     * with the same @p handle.
+     *
+     * @param handle       The handle to the previously created scan state.
+     * @param text         Pointer to the UTF-8 bytes to scan.
+     * @param n            Number of bytes to scan.
+     * @param max_columns  Maximum number of columns to scan.
+     */
+    u8_scan_result_t u8_scan_text(u8_scan_state_t handle, u8_char_t const* text, size_t n, size_t max_columns);
+
 #if !defined(__cplusplus)
 }
 #endif
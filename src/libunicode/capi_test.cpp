@@ -57,4 +57,65 @@ TEST_CASE("capi.u8u32_stream_convert_and_inverse")
     CHECK(inverseSV == input);
 }
 
-// TODO more C-API tests
+TEST_CASE("capi.u8_gc_count_and_width")
+{
+    auto constexpr text = "Hi \xF0\x9F\x98\x80\xEF\xB8\x8E e\xCC\x81 \xE0\xA4\x95\xE0\xA4\xBE"sv; // Hi 😀︎ é का
+    CHECK(u8_gc_count(text.data(), text.size()) == 8);
+    CHECK(u8_gc_width(text.data(), text.size(), GC_WIDTH_MODE_MODIFIABLE) == 10);
+    CHECK(u8_gc_width(text.data(), text.size(), GC_WIDTH_MODE_NON_MODIFIABLE) == 9);
+    CHECK(u8_gc_count("", 0) == 0);
+    CHECK(u8_gc_width("", 0, GC_WIDTH_MODE_MODIFIABLE) == 0);
+}
+
+TEST_CASE("capi.u8_gc_batch")
+{
+    auto const strings = array<u8_char_t const*, 3> { "abc", "\xE4\xB8\xAD\xE6\x96\x87", "" };
+    auto const sizes = array<size_t, 3> { 3, 6, 0 };
+
+    auto counts = array<int, 3> {};
+    u8_gc_count_batch(strings.data(), sizes.data(), strings.size(), counts.data());
+    CHECK(counts == array<int, 3> { 3, 2, 0 });
+
+    auto widths = array<int, 3> {};
+    u8_gc_width_batch(strings.data(), sizes.data(), strings.size(), GC_WIDTH_MODE_MODIFIABLE, widths.data());
+    CHECK(widths == array<int, 3> { 3, 4, 0 });
+}
+
+TEST_CASE("capi.u32u8_convert_exact_fit")
+{
+    auto constexpr input = U"ab\u20ACc"sv;
+    array<u8_char_t, 6> exact {};
+    CHECK(u32u8_convert((u32_char_t const*) input.data(), input.size(), exact.data(), exact.size()) == 6);
+    CHECK(string_view(exact.data(), exact.size()) == "ab\xE2\x82\xAC" "c"sv);
+
+    array<u8_char_t, 4> tooSmall {};
+    CHECK(u32u8_convert((u32_char_t const*) input.data(), input.size(), tooSmall.data(), tooSmall.size()) == -1);
+}
+
+TEST_CASE("capi.u8_scan_text")
+{
+    u8_scan_state_t state = u8_scan_state_create();
+
+    // A UTF-8 sequence split across two calls is continued by the second.
+    auto constexpr first = "ab\xE4\xB8"sv;
+    auto const r1 = u8_scan_text(state, first.data(), first.size(), 80);
+    CHECK(r1.columns == 2);
+    CHECK(r1.consumed == 4);
+    CHECK(r1.text_end == 2);
+
+    auto constexpr second = "\xADxyz"sv;
+    auto const r2 = u8_scan_text(state, second.data(), second.size(), 80);
+    CHECK(r2.columns == 5);
+    CHECK(r2.consumed == 4);
+    CHECK(r2.text_end == 4);
+
+    // The scan stops before a cluster that does not fit.
+    u8_scan_state_reset(state);
+    auto constexpr wide = "a\xE4\xB8\xAD"sv;
+    auto const r3 = u8_scan_text(state, wide.data(), wide.size(), 2);
+    CHECK(r3.columns == 1);
+    CHECK(r3.consumed == 1);
+
+    u8_scan_state_destroy(&state);
+    CHECK(state == nullptr);
+}
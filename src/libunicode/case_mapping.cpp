@@ -12,17 +12,61 @@
  * limitations under the License.
  */
 #include <libunicode/case_mapping.h>
+#include <libunicode/case_mapping_simd_impl.h>
 #include <libunicode/case_normalization_data.h>
+#include <libunicode/codepoint_reader.h>
 #include <libunicode/convert.h>
+#include <libunicode/support.h>
 #include <libunicode/ucd.h>
 #include <libunicode/word_segmenter.h>
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 
+#if (defined(LIBUNICODE_USE_STD_SIMD) || defined(LIBUNICODE_USE_INTRINSICS)) && (defined(__x86_64__) || defined(_M_AMD64))
+    #include <libunicode/simd_detector.h>
+#endif
+
 namespace unicode
 {
 
+size_t detail::ascii_case_map(char const* input, size_t inputSize, char* output, char first, char last) noexcept
+{
+#if (defined(LIBUNICODE_USE_STD_SIMD) || defined(LIBUNICODE_USE_INTRINSICS)) && (defined(__x86_64__) || defined(_M_AMD64))
+    static auto const simdSize = max_simd_size();
+    if (simdSize == 512)
+        return ascii_case_map_512(input, inputSize, output, first, last);
+    if (simdSize == 256)
+        return ascii_case_map_256(input, inputSize, output, first, last);
+#endif
+    return ascii_case_map_simd<128>(input, inputSize, output, first, last);
+}
+
+size_t detail::ascii_casefold_common_prefix(char const* a, char const* b, size_t size) noexcept
+{
+#if (defined(LIBUNICODE_USE_STD_SIMD) || defined(LIBUNICODE_USE_INTRINSICS)) && (defined(__x86_64__) || defined(_M_AMD64))
+    static auto const simdSize = max_simd_size();
+    if (simdSize == 512)
+        return ascii_casefold_common_prefix_512(a, b, size);
+    if (simdSize == 256)
+        return ascii_casefold_common_prefix_256(a, b, size);
+#endif
+    return ascii_casefold_common_prefix_simd<128>(a, b, size);
+}
+
+size_t detail::find_ascii_casefold_candidate(char const* text, size_t size, char key) noexcept
+{
+#if (defined(LIBUNICODE_USE_STD_SIMD) || defined(LIBUNICODE_USE_INTRINSICS)) && (defined(__x86_64__) || defined(_M_AMD64))
+    static auto const simdSize = max_simd_size();
+    if (simdSize == 512)
+        return find_ascii_casefold_candidate_512(text, size, key);
+    if (simdSize == 256)
+        return find_ascii_casefold_candidate_256(text, size, key);
+#endif
+    return find_ascii_casefold_candidate_simd<128>(text, size, key);
+}
+
 namespace
 {
     // Binary search helper for sorted pair arrays
@@ -58,6 +102,135 @@ namespace
         return {}; // Identity mapping
     }
 
+    // Encodes the full case mapping of @p codepoint as UTF-8 into @p output and returns the end of the
+    // written bytes. Writes at most 4 * MaxCaseMappingLength bytes.
+    template <typename FullMapping>
+    char* encode_mapped(char32_t codepoint, FullMapping fullMapping, char* output)
+    {
+        auto const mapping = fullMapping(codepoint);
+        if (mapping.is_identity())
+            return encoder<char> {}(codepoint, output);
+        for (auto const mapped: mapping.view())
+            output = encoder<char> {}(mapped, output);
+        return output;
+    }
+
+    // Appends the case mapping of the UTF-8 @p text to @p result.
+    //
+    // ASCII runs are mapped blockwise by flipping the case bit of all bytes in [first, last],
+    // only the non-ASCII runs in between are decoded and mapped codepoint by codepoint.
+    // Invalid UTF-8 sequences are dropped, like convert_to<char32_t>() does.
+    template <typename FullMapping>
+    void append_case_mapped(std::string& result, std::string_view text, char first, char last, FullMapping fullMapping)
+    {
+        auto out = result.size();
+        result.resize(out + text.size());
+
+        auto i = size_t { 0 };
+        auto decode = decoder<char> {};
+        while (i < text.size())
+        {
+            if (!decode.expectedLength)
+            {
+                auto const count = detail::ascii_case_map(text.data() + i, text.size() - i, result.data() + out, first, last);
+                i += count;
+                out += count;
+                if (i == text.size())
+                    break;
+            }
+
+            auto const decoded = decode(static_cast<uint8_t>(text[i++]));
+            if (!decoded)
+                continue;
+
+            // Keep room for the longest possible mapping plus the remaining input mapped 1:1.
+            auto const required = out + 4 * MaxCaseMappingLength + (text.size() - i);
+            if (required > result.size())
+                result.resize(required + required / 2);
+
+            out = static_cast<size_t>(encode_mapped(*decoded, fullMapping, result.data() + out) - result.data());
+        }
+
+        result.resize(out);
+    }
+
+    template <typename FullMapping>
+    std::string case_mapped(std::string_view text, char first, char last, FullMapping fullMapping)
+    {
+        std::string result;
+        append_case_mapped(result, text, first, last, fullMapping);
+        return result;
+    }
+
+    // Maps the UTF-8 @p text in place for as long as the mapped codepoints keep their byte length,
+    // and falls back to out-of-place mapping for the remainder otherwise.
+    template <typename FullMapping>
+    void case_map_in_place(std::string& text, char first, char last, FullMapping fullMapping)
+    {
+        auto i = size_t { 0 };
+        auto start = size_t { 0 };
+        auto decode = decoder<char> {};
+
+        auto const mapRemainder = [&]() {
+            auto const tail = case_mapped(std::string_view(text).substr(start), first, last, fullMapping);
+            text.replace(start, std::string::npos, tail);
+        };
+
+        while (i < text.size())
+        {
+            if (!decode.expectedLength)
+            {
+                i += detail::ascii_case_map(text.data() + i, text.size() - i, text.data() + i, first, last);
+                if (i == text.size())
+                    return;
+                start = i;
+            }
+
+            auto const decoded = decode(static_cast<uint8_t>(text[i++]));
+            if (!decoded)
+            {
+                if (decode.expectedLength)
+                    continue; // incomplete sequence
+                return mapRemainder(); // invalid byte, which is dropped
+            }
+
+            char buffer[4 * MaxCaseMappingLength];
+            auto const length = static_cast<size_t>(encode_mapped(*decoded, fullMapping, buffer) - buffer);
+            if (length != i - start)
+                return mapRemainder();
+            std::memcpy(text.data() + start, buffer, length);
+        }
+
+        if (decode.expectedLength)
+            mapRemainder(); // drops the trailing incomplete sequence
+    }
+
+    void hash_casefolded(codepoint_hasher& hasher, char32_t codepoint) noexcept
+    {
+        auto const mapping = full_casefold(codepoint);
+        if (mapping.is_identity())
+            hasher(codepoint);
+        else
+            for (auto const folded: mapping.view())
+                hasher(folded);
+    }
+
+    template <typename Reader>
+    int lazy_casefold_compare(Reader a, Reader b) noexcept
+    {
+        auto foldedA = detail::casefold_reader<Reader>(a);
+        auto foldedB = detail::casefold_reader<Reader>(b);
+        while (true)
+        {
+            auto const codepointA = foldedA.next();
+            auto const codepointB = foldedB.next();
+            if (!codepointA || !codepointB)
+                return static_cast<int>(codepointA.has_value()) - static_cast<int>(codepointB.has_value());
+            if (*codepointA != *codepointB)
+                return *codepointA < *codepointB ? -1 : 1;
+        }
+    }
+
 } // namespace
 
 // ============================================================================
@@ -287,16 +460,12 @@ std::u32string casefold(std::u32string_view text)
 
 std::string to_uppercase(std::string_view text)
 {
-    auto const u32text = convert_to<char32_t>(text);
-    auto const u32result = to_uppercase(std::u32string_view(u32text));
-    return convert_to<char>(std::u32string_view(u32result));
+    return case_mapped(text, 'a', 'z', full_uppercase);
 }
 
 std::string to_lowercase(std::string_view text)
 {
-    auto const u32text = convert_to<char32_t>(text);
-    auto const u32result = to_lowercase(std::u32string_view(u32text));
-    return convert_to<char>(std::u32string_view(u32result));
+    return case_mapped(text, 'A', 'Z', full_lowercase);
 }
 
 std::string to_titlecase(std::string_view text)
@@ -308,39 +477,100 @@ std::string to_titlecase(std::string_view text)
 
 std::string casefold(std::string_view text)
 {
-    auto const u32text = convert_to<char32_t>(text);
-    auto const u32result = casefold(std::u32string_view(u32text));
-    return convert_to<char>(std::u32string_view(u32result));
+    return case_mapped(text, 'A', 'Z', full_casefold);
+}
+
+void to_uppercase_in_place(std::string& text)
+{
+    case_map_in_place(text, 'a', 'z', full_uppercase);
+}
+
+void to_lowercase_in_place(std::string& text)
+{
+    case_map_in_place(text, 'A', 'Z', full_lowercase);
+}
+
+void casefold_in_place(std::string& text)
+{
+    case_map_in_place(text, 'A', 'Z', full_casefold);
 }
 
 // ============================================================================
 // Case-insensitive comparison
 // ============================================================================
 
-int casefold_compare(std::u32string_view a, std::u32string_view b)
+int casefold_compare(std::u32string_view a, std::u32string_view b) noexcept
 {
-    auto const folded_a = casefold(a);
-    auto const folded_b = casefold(b);
-    return folded_a.compare(folded_b);
+    auto const isAsciiFoldEqual = [](char32_t x, char32_t y) noexcept {
+        return x < 0x80 && y < 0x80 && simple_casefold(x) == simple_casefold(y);
+    };
+
+    auto prefix = size_t { 0 };
+    auto const size = std::min(a.size(), b.size());
+    while (prefix < size && isAsciiFoldEqual(a[prefix], b[prefix]))
+        ++prefix;
+
+    return lazy_casefold_compare(detail::u32_codepoint_reader { a.substr(prefix) },
+                                 detail::u32_codepoint_reader { b.substr(prefix) });
 }
 
-int casefold_compare(std::string_view a, std::string_view b)
+int casefold_compare(std::string_view a, std::string_view b) noexcept
 {
-    auto const folded_a = casefold(a);
-    auto const folded_b = casefold(b);
-    return folded_a.compare(folded_b);
+    auto const prefix = detail::ascii_casefold_common_prefix(a.data(), b.data(), std::min(a.size(), b.size()));
+    return lazy_casefold_compare(detail::utf8_codepoint_reader { a.substr(prefix) },
+                                 detail::utf8_codepoint_reader { b.substr(prefix) });
 }
 
-bool casefold_equals(std::u32string_view a, std::u32string_view b)
+bool casefold_equals(std::u32string_view a, std::u32string_view b) noexcept
 {
     return casefold_compare(a, b) == 0;
 }
 
-bool casefold_equals(std::string_view a, std::string_view b)
+bool casefold_equals(std::string_view a, std::string_view b) noexcept
 {
     return casefold_compare(a, b) == 0;
 }
 
+uint64_t casefold_hash(std::u32string_view text) noexcept
+{
+    auto hasher = codepoint_hasher {};
+    for (auto const codepoint: text)
+    {
+        if (codepoint < 0x80)
+            hasher(simple_casefold(codepoint));
+        else
+            hash_casefolded(hasher, codepoint);
+    }
+    return hasher.value();
+}
+
+uint64_t casefold_hash(std::string_view text) noexcept
+{
+    auto hasher = codepoint_hasher {};
+    auto i = size_t { 0 };
+    while (i < text.size())
+    {
+        // Fold the ASCII run blockwise into a scratch buffer and hash the folded bytes.
+        char folded[256];
+        auto const chunkSize = std::min(text.size() - i, sizeof(folded));
+        auto const count = detail::ascii_case_map(text.data() + i, chunkSize, folded, 'A', 'Z');
+        for (size_t k = 0; k < count; ++k)
+            hasher(static_cast<char32_t>(folded[k]));
+        i += count;
+        if (count == chunkSize)
+            continue;
+
+        // Decode the non-ASCII run up to the next ASCII byte at a codepoint boundary.
+        auto decode = decoder<char> {};
+        do
+        {
+            if (auto const decoded = decode(static_cast<uint8_t>(text[i++])); decoded)
+                hash_casefolded(hasher, *decoded);
+        } while (i < text.size() && (decode.expectedLength || static_cast<uint8_t>(text[i]) >= 0x80));
+    }
+    return hasher.value();
+}
+
 // ============================================================================
 // Case property queries
 // ============================================================================
@@ -115,22 +115,56 @@ struct case_mapping_result
 /// Case-folds a UTF-8 string.
 [[nodiscard]] std::string casefold(std::string_view text);
 
+/// Converts a UTF-8 string to uppercase in place.
+///
+/// Mapped codepoints are written over the original bytes as long as their UTF-8 length is unchanged,
+/// which always holds for ASCII. The string is only reallocated from the first codepoint whose mapping
+/// changes the byte length (e.g. ß -> SS) or the first invalid UTF-8 sequence onwards.
+void to_uppercase_in_place(std::string& text);
+
+/// Converts a UTF-8 string to lowercase in place.
+/// @see to_uppercase_in_place()
+void to_lowercase_in_place(std::string& text);
+
+/// Case-folds a UTF-8 string in place.
+/// @see to_uppercase_in_place()
+void casefold_in_place(std::string& text);
+
 // ============================================================================
 // Case-insensitive comparison
 // ============================================================================
 
 /// Compares two UTF-32 strings case-insensitively using case folding.
+///
+/// Both strings are case-folded lazily while comparing, so no memory is allocated and the
+/// comparison stops at the first difference.
+///
 /// @return negative if a < b, 0 if equal, positive if a > b
-[[nodiscard]] int casefold_compare(std::u32string_view a, std::u32string_view b);
+[[nodiscard]] int casefold_compare(std::u32string_view a, std::u32string_view b) noexcept;
 
 /// Compares two UTF-8 strings case-insensitively using case folding.
-[[nodiscard]] int casefold_compare(std::string_view a, std::string_view b);
+///
+/// The common ASCII prefix is compared blockwise, the remainder is decoded and case-folded lazily.
+/// The order equals the bytewise order of casefold(a) and casefold(b).
+/// Invalid UTF-8 sequences are skipped, as convert_to<char32_t>() does.
+[[nodiscard]] int casefold_compare(std::string_view a, std::string_view b) noexcept;
 
 /// Checks if two strings are equal when case-folded.
-[[nodiscard]] bool casefold_equals(std::u32string_view a, std::u32string_view b);
+[[nodiscard]] bool casefold_equals(std::u32string_view a, std::u32string_view b) noexcept;
 
 /// Checks if two UTF-8 strings are equal when case-folded.
-[[nodiscard]] bool casefold_equals(std::string_view a, std::string_view b);
+[[nodiscard]] bool casefold_equals(std::string_view a, std::string_view b) noexcept;
+
+/// Returns the hash of the full case folding of @p text, without materializing it.
+///
+/// Strings that are equal according to casefold_equals() have equal hashes, so both can be used
+/// as the hash and key-equal functions of an unordered container with case-insensitive keys.
+[[nodiscard]] uint64_t casefold_hash(std::u32string_view text) noexcept;
+
+/// Returns the hash of the full case folding of the UTF-8 string @p text.
+///
+/// ASCII runs are folded blockwise. The hash equals casefold_hash() of the same text in UTF-32.
+[[nodiscard]] uint64_t casefold_hash(std::string_view text) noexcept;
 
 // ============================================================================
 // Case property queries
@@ -154,4 +188,27 @@ struct case_mapping_result
 /// Returns true if the codepoint changes when case-folded.
 [[nodiscard]] bool changes_when_casefolded(char32_t codepoint) noexcept;
 
+namespace detail
+{
+    // Flips the case bit of all bytes in [first, last] within the ASCII prefix of input, writing to output
+    // (which may alias input). Returns the length of the ASCII prefix (defined in case_mapping.cpp).
+    size_t ascii_case_map(char const* input, size_t inputSize, char* output, char first, char last) noexcept;
+
+    // Returns the length of the common prefix of a and b (both at least size bytes) that is ASCII
+    // and equal after folding 'A'..'Z' to lowercase (defined in case_mapping.cpp).
+    size_t ascii_casefold_common_prefix(char const* a, char const* b, size_t size) noexcept;
+
+    // Returns the offset of the first byte in text that is non-ASCII or equals key ignoring bit 0x20,
+    // or size if there is none (defined in case_mapping.cpp).
+    size_t find_ascii_casefold_candidate(char const* text, size_t size, char key) noexcept;
+
+    // Arch-specific SIMD instantiations (defined in case_mapping256.cpp / case_mapping512.cpp)
+    size_t ascii_case_map_256(char const* input, size_t inputSize, char* output, char first, char last) noexcept;
+    size_t ascii_case_map_512(char const* input, size_t inputSize, char* output, char first, char last) noexcept;
+    size_t ascii_casefold_common_prefix_256(char const* a, char const* b, size_t size) noexcept;
+    size_t ascii_casefold_common_prefix_512(char const* a, char const* b, size_t size) noexcept;
+    size_t find_ascii_casefold_candidate_256(char const* text, size_t size, char key) noexcept;
+    size_t find_ascii_casefold_candidate_512(char const* text, size_t size, char key) noexcept;
+} // namespace detail
+
 } // namespace unicode
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <libunicode/case_mapping_simd_impl.h>
+
+namespace unicode::detail
+{
+
+size_t ascii_case_map_256(char const* input, size_t inputSize, char* output, char first, char last) noexcept
+{
+    return ascii_case_map_simd<256>(input, inputSize, output, first, last);
+}
+
+size_t ascii_casefold_common_prefix_256(char const* a, char const* b, size_t size) noexcept
+{
+    return ascii_casefold_common_prefix_simd<256>(a, b, size);
+}
+
+size_t find_ascii_casefold_candidate_256(char const* text, size_t size, char key) noexcept
+{
+    return find_ascii_casefold_candidate_simd<256>(text, size, key);
+}
+
+} // namespace unicode::detail
@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <libunicode/case_mapping.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// clang-format off
+#if __has_include(<experimental/simd>) && defined(LIBUNICODE_USE_STD_SIMD) && !defined(_LIBCPP_VERSION)
+    #define USE_STD_SIMD_CASE_MAPPING
+    #include <experimental/simd>
+    namespace case_mapping_stdx = std::experimental;
+#elif __has_include(<simd>) && defined(LIBUNICODE_USE_STD_SIMD)
+    #define USE_STD_SIMD_CASE_MAPPING
+    #include <simd>
+    namespace case_mapping_stdx = std;
+#elif defined(LIBUNICODE_USE_INTRINSICS)
+    #include "intrinsics.h"
+#endif
+// clang-format on
+
+namespace unicode::detail
+{
+
+// =====================================================================================
+// ASCII case mapping
+// =====================================================================================
+
+/// Maps the ASCII prefix of @p input to the other case, flipping bit 0x20 of every byte
+/// within [@p first, @p last] (['A', 'Z'] for lowercasing, ['a', 'z'] for uppercasing).
+///
+/// @param input     Pointer to UTF-8 input bytes.
+/// @param inputSize Number of input bytes.
+/// @param output    Pointer to the output buffer (may be equal to @p input).
+/// @param first     First byte value to map.
+/// @param last      Last byte value to map.
+/// @return Number of bytes processed, i.e. the length of the ASCII prefix.
+template <size_t SimdBitWidth>
+size_t ascii_case_map_simd(char const* input, size_t inputSize, char* output, char first, char last) noexcept
+{
+    [[maybe_unused]] constexpr int simd_size = SimdBitWidth / 8;
+    size_t i = 0;
+
+#if defined(USE_STD_SIMD_CASE_MAPPING)
+    using batch_t = case_mapping_stdx::fixed_size_simd<signed char, simd_size>;
+    while (i + simd_size <= inputSize)
+    {
+        auto batch = batch_t(reinterpret_cast<signed char const*>(input + i), case_mapping_stdx::element_aligned);
+        if (case_mapping_stdx::any_of(batch < 0))
+            break;
+        auto const in_range = batch >= static_cast<signed char>(first) && batch <= static_cast<signed char>(last);
+        case_mapping_stdx::where(in_range, batch) ^= static_cast<signed char>(0x20);
+        batch.copy_to(reinterpret_cast<signed char*>(output + i), case_mapping_stdx::element_aligned);
+        i += simd_size;
+    }
+#elif defined(LIBUNICODE_USE_INTRINSICS)
+    #if defined(__aarch64__) || defined(_M_ARM64)
+    static_assert(SimdBitWidth == 128, "ARM64 NEON only supports 128-bit SIMD");
+    #endif
+    using simd = intrinsics<SimdBitWidth>;
+    auto const below_first = simd::set1_epi8(static_cast<signed char>(first - 1));
+    auto const above_last = simd::set1_epi8(static_cast<signed char>(last + 1));
+    auto const case_bit = simd::set1_epi8(0x20);
+    while (i + simd_size <= inputSize)
+    {
+        auto const batch = simd::load(input + i);
+        if (!simd::all_ascii(batch))
+            break;
+        auto const in_range = simd::and_vec(simd::cmpgt_epi8(batch, below_first), simd::cmpgt_epi8(above_last, batch));
+        simd::store(output + i, simd::xor_vec(batch, simd::and_vec(in_range, case_bit)));
+        i += simd_size;
+    }
+#endif
+
+    for (; i < inputSize; ++i)
+    {
+        auto const ch = input[i];
+        if (static_cast<uint8_t>(ch) & 0x80)
+            break;
+        output[i] = (ch >= first && ch <= last) ? static_cast<char>(ch ^ 0x20) : ch;
+    }
+
+    return i;
+}
+
+/// Returns the length of the common prefix of @p a and @p b that consists of ASCII bytes only
+/// and matches case-insensitively, i.e. with 'A'..'Z' folded to 'a'..'z'.
+///
+/// @param a    Pointer to the first UTF-8 input.
+/// @param b    Pointer to the second UTF-8 input.
+/// @param size Number of bytes to compare (at most the size of the shorter input).
+template <size_t SimdBitWidth>
+size_t ascii_casefold_common_prefix_simd(char const* a, char const* b, size_t size) noexcept
+{
+    [[maybe_unused]] constexpr int simd_size = SimdBitWidth / 8;
+    size_t i = 0;
+
+#if defined(USE_STD_SIMD_CASE_MAPPING)
+    using batch_t = case_mapping_stdx::fixed_size_simd<signed char, simd_size>;
+    auto const fold_batch = [](batch_t batch) {
+        case_mapping_stdx::where(batch >= 'A' && batch <= 'Z', batch) |= static_cast<signed char>(0x20);
+        return batch;
+    };
+    while (i + simd_size <= size)
+    {
+        auto const batchA = batch_t(reinterpret_cast<signed char const*>(a + i), case_mapping_stdx::element_aligned);
+        auto const batchB = batch_t(reinterpret_cast<signed char const*>(b + i), case_mapping_stdx::element_aligned);
+        if (case_mapping_stdx::any_of((batchA | batchB) < 0) || case_mapping_stdx::any_of(fold_batch(batchA) != fold_batch(batchB)))
+            break;
+        i += simd_size;
+    }
+#elif defined(LIBUNICODE_USE_INTRINSICS)
+    #if defined(__aarch64__) || defined(_M_ARM64)
+    static_assert(SimdBitWidth == 128, "ARM64 NEON only supports 128-bit SIMD");
+    #endif
+    using simd = intrinsics<SimdBitWidth>;
+    auto const below_upper = simd::set1_epi8('A' - 1);
+    auto const above_upper = simd::set1_epi8('Z' + 1);
+    auto const case_bit = simd::set1_epi8(0x20);
+    auto const zero = simd::setzero();
+    auto const fold_batch = [&](auto batch) {
+        auto const is_upper = simd::and_vec(simd::cmpgt_epi8(batch, below_upper), simd::cmpgt_epi8(above_upper, batch));
+        return simd::or_vec(batch, simd::and_vec(is_upper, case_bit));
+    };
+    while (i + simd_size <= size)
+    {
+        auto const batchA = simd::load(a + i);
+        auto const batchB = simd::load(b + i);
+        if (!simd::all_ascii(simd::or_vec(batchA, batchB)))
+            break;
+        // Both folded batches are ASCII, so any difference yields a positive byte.
+        if (simd::to_unsigned(simd::greater(simd::xor_vec(fold_batch(batchA), fold_batch(batchB)), zero)))
+            break;
+        i += simd_size;
+    }
+#endif
+
+    auto const fold_byte = [](char ch) noexcept {
+        return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch | 0x20) : ch;
+    };
+    for (; i < size; ++i)
+    {
+        if ((static_cast<uint8_t>(a[i]) | static_cast<uint8_t>(b[i])) & 0x80)
+            break;
+        if (fold_byte(a[i]) != fold_byte(b[i]))
+            break;
+    }
+
+    return i;
+}
+
+/// Returns the offset of the first byte in @p text that is either non-ASCII or equal to @p key
+/// when ignoring bit 0x20 (i.e. @p key in either case if it is a letter), or @p size if there is none.
+///
+/// This is the first-byte prefilter of the case-insensitive search for ASCII needles,
+/// non-ASCII bytes are reported as they might start a codepoint that folds to @p key (e.g. KELVIN SIGN).
+template <size_t SimdBitWidth>
+size_t find_ascii_casefold_candidate_simd(char const* text, size_t size, char key) noexcept
+{
+    [[maybe_unused]] constexpr int simd_size = SimdBitWidth / 8;
+    auto const folded_key = static_cast<signed char>(key | 0x20);
+    size_t i = 0;
+
+#if defined(USE_STD_SIMD_CASE_MAPPING)
+    using batch_t = case_mapping_stdx::fixed_size_simd<signed char, simd_size>;
+    auto const case_bit = batch_t(static_cast<signed char>(0x20));
+    auto const key_batch = batch_t(folded_key);
+    while (i + simd_size <= size)
+    {
+        auto const batch = batch_t(reinterpret_cast<signed char const*>(text + i), case_mapping_stdx::element_aligned);
+        auto const candidates = batch < batch_t(0) || (batch | case_bit) == key_batch;
+        if (case_mapping_stdx::any_of(candidates))
+            return i + static_cast<size_t>(case_mapping_stdx::find_first_set(candidates));
+        i += simd_size;
+    }
+#elif defined(LIBUNICODE_USE_INTRINSICS)
+    #if defined(__aarch64__) || defined(_M_ARM64)
+    static_assert(SimdBitWidth == 128, "ARM64 NEON only supports 128-bit SIMD");
+    #endif
+    using simd = intrinsics<SimdBitWidth>;
+    using mask_t = typename simd::mask_t;
+    auto const case_bit = simd::set1_epi8(0x20);
+    auto const key_batch = simd::set1_epi8(folded_key);
+    auto const zero = simd::setzero();
+    while (i + simd_size <= size)
+    {
+        auto const batch = simd::load(text + i);
+        auto const lowered = simd::or_vec(batch, case_bit);
+        auto const differs = simd::or_mask(simd::greater(lowered, key_batch), simd::less(lowered, key_batch));
+        // Inverting the mask may also set bits beyond the lane count, hence the offset check below.
+        auto const candidates = simd::or_mask(simd::less(batch, zero), simd::xor_mask(differs, static_cast<mask_t>(~0ull)));
+        if (auto const offset = static_cast<size_t>(std::countr_zero(simd::to_unsigned(candidates)));
+            offset < static_cast<size_t>(simd_size))
+            return i + offset;
+        i += simd_size;
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        auto const byte = static_cast<uint8_t>(text[i]);
+        if ((byte & 0x80) || static_cast<signed char>(byte | 0x20) == folded_key)
+            return i;
+    }
+
+    return size;
+}
+
+} // namespace unicode::detail
@@ -12,9 +12,14 @@
  * limitations under the License.
  */
 #include <libunicode/case_mapping.h>
+#include <libunicode/convert.h>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
+#include <string>
+#include <unordered_set>
+
 using namespace unicode;
 using namespace std::string_view_literals;
 
@@ -136,6 +141,63 @@ TEST_CASE("case_mapping.casefold_string", "[case_mapping]")
     CHECK(casefold("straße"sv) == "strasse");
 }
 
+TEST_CASE("case_mapping.utf8_ascii_blocks", "[case_mapping]")
+{
+    // Mixes ASCII runs longer than a 512-bit block with non-ASCII codepoints (including ones whose
+    // mapping changes the UTF-8 length) at varying offsets, comparing against the UTF-32 code path.
+    auto const ascii = "The Quick Brown Fox Jumps Over The Lazy Dog @[`{ 0123456789 "sv;
+    auto const specials = std::array { "É"sv, "ß"sv, "ǅ"sv, "ﬃ"sv, "Ω"sv, "İ"sv, "ⱥ"sv, "😀"sv };
+
+    for (size_t offset = 0; offset < ascii.size(); offset += 7)
+    {
+        auto text = std::string(ascii.substr(offset));
+        for (auto const special: specials)
+        {
+            text += special;
+            text += ascii;
+        }
+
+        auto const u32text = convert_to<char32_t>(std::string_view(text));
+        INFO("offset: " << offset);
+        CHECK(to_lowercase(std::string_view(text)) == convert_to<char>(std::u32string_view(to_lowercase(u32text))));
+        CHECK(to_uppercase(std::string_view(text)) == convert_to<char>(std::u32string_view(to_uppercase(u32text))));
+        CHECK(casefold(std::string_view(text)) == convert_to<char>(std::u32string_view(casefold(u32text))));
+    }
+}
+
+TEST_CASE("case_mapping.in_place", "[case_mapping]")
+{
+    auto const check = [](std::string_view input) {
+        INFO("input: " << input);
+
+        auto lower = std::string(input);
+        to_lowercase_in_place(lower);
+        CHECK(lower == to_lowercase(input));
+
+        auto upper = std::string(input);
+        to_uppercase_in_place(upper);
+        CHECK(upper == to_uppercase(input));
+
+        auto folded = std::string(input);
+        casefold_in_place(folded);
+        CHECK(folded == casefold(input));
+    };
+
+    check(""sv);
+    check("Content-Type: text/html; charset=UTF-8"sv);
+    check("Ärger über Öl"sv);     // same byte length
+    check("Straße und MAẞE"sv);   // ß changes byte length when uppercased
+    check("ǅemal ǈubljana ﬁx"sv); // titlecase digraphs and ligatures
+    check("abc\xC3"sv);           // trailing incomplete sequence
+    check("abc\x80" "DEF"sv);     // invalid byte
+
+    auto text = std::string("X-Forwarded-For");
+    auto const* data = text.data();
+    to_lowercase_in_place(text);
+    CHECK(text == "x-forwarded-for");
+    CHECK(text.data() == data);
+}
+
 TEST_CASE("case_mapping.casefold_compare", "[case_mapping]")
 {
     CHECK(casefold_compare("hello"sv, "HELLO"sv) == 0);
@@ -147,6 +209,45 @@ TEST_CASE("case_mapping.casefold_compare", "[case_mapping]")
     CHECK(casefold_compare("straße"sv, "STRASSE"sv) == 0);
 }
 
+TEST_CASE("case_mapping.casefold_compare_lazy", "[case_mapping]")
+{
+    auto const sign = [](int value) { return (value > 0) - (value < 0); };
+
+    // The lazy comparison must order like comparing the materialized case foldings.
+    auto const check = [&](std::string_view a, std::string_view b) {
+        INFO("a: " << a << ", b: " << b);
+        auto const expected = sign(casefold(a).compare(casefold(b)));
+        CHECK(sign(casefold_compare(a, b)) == expected);
+        CHECK(sign(casefold_compare(b, a)) == -expected);
+
+        auto const u32a = convert_to<char32_t>(a);
+        auto const u32b = convert_to<char32_t>(b);
+        CHECK(sign(casefold_compare(std::u32string_view(u32a), std::u32string_view(u32b))) == expected);
+        CHECK(casefold_equals(std::u32string_view(u32a), std::u32string_view(u32b)) == (expected == 0));
+    };
+
+    check("KELVIN"sv, "\u212Aelvin"sv); // KELVIN SIGN folds to ASCII k
+    check("Maße"sv, "MASSE"sv);
+    check("Maß"sv, "MASSE"sv);
+    check("ﬃ"sv, "FFI"sv);
+    check("ǅ"sv, "dž"sv);
+    check("abc"sv, "abcd"sv);
+    check("ab["sv, "abZ"sv); // '[' sorts between 'Z' and 'z'
+
+    // Long ASCII prefixes spanning several SIMD blocks, differing at every position.
+    auto const base = std::string(150, 'x') + "Straße";
+    for (size_t i = 0; i < base.size(); i += 5)
+    {
+        auto upper = base;
+        upper[i] = 'X';
+        check(base, upper);
+
+        auto other = base;
+        other[i] = 'y';
+        check(base, other);
+    }
+}
+
 TEST_CASE("case_mapping.casefold_equals", "[case_mapping]")
 {
     CHECK(casefold_equals("hello"sv, "HELLO"sv));
@@ -157,6 +258,34 @@ TEST_CASE("case_mapping.casefold_equals", "[case_mapping]")
     CHECK(casefold_equals("straße"sv, "STRASSE"sv));
 }
 
+TEST_CASE("case_mapping.casefold_hash", "[case_mapping]")
+{
+    auto const check = [](std::string_view a, std::string_view b) {
+        INFO("a: " << a << ", b: " << b);
+        REQUIRE(casefold_equals(a, b));
+        CHECK(casefold_hash(a) == casefold_hash(b));
+        CHECK(casefold_hash(a) == casefold_hash(std::u32string_view(convert_to<char32_t>(a))));
+        CHECK(casefold_hash(b) == casefold_hash(std::u32string_view(convert_to<char32_t>(b))));
+    };
+
+    check("Content-Length"sv, "content-length"sv);
+    check("Straße"sv, "STRASSE"sv);
+    check("\u212Aelvin"sv, "KELVIN"sv);
+    check("ﬃ"sv, "FFI"sv);
+    check(std::string(300, 'Q') + "ß" + std::string(70, 'W'), std::string(300, 'q') + "SS" + std::string(70, 'w'));
+    check("a\x80" "B"sv, "AB"sv); // invalid UTF-8 is skipped
+
+    CHECK(casefold_hash("abc"sv) != casefold_hash("abd"sv));
+    CHECK(casefold_hash(""sv) == casefold_hash(std::u32string_view {}));
+
+    auto const hash = [](std::string_view text) { return casefold_hash(text); };
+    auto const equal = [](std::string_view a, std::string_view b) { return casefold_equals(a, b); };
+    auto keys = std::unordered_set<std::string_view, decltype(hash), decltype(equal)>(0, hash, equal);
+    keys.insert("Accept-Encoding"sv);
+    CHECK(keys.count("ACCEPT-ENCODING"sv) == 1);
+    CHECK(keys.count("Accept-Language"sv) == 0);
+}
+
 TEST_CASE("case_mapping.is_cased", "[case_mapping]")
 {
     CHECK(is_cased('A'));
@@ -0,0 +1,308 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/case_mapping.h>
+#include <libunicode/casefold_search.h>
+#include <libunicode/convert.h>
+#include <libunicode/grapheme_segmenter.h>
+#include <libunicode/utf8.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace unicode
+{
+
+namespace
+{
+    // Answers whether byte offsets of a UTF-8 text are grapheme cluster boundaries.
+    //
+    // Segmentation does not need to start at the beginning of the text: the state after any ASCII
+    // codepoint does not depend on what precedes it, so queries restart at the closest ASCII
+    // codepoint before the queried offset, or continue from the previous query if that is closer.
+    //
+    // Queries mostly come in increasing order, except that a match's begin may lie before the end
+    // of the match tested just before. Such a query resumes from the state kept at the previous query,
+    // as restarting at an ASCII codepoint would go all the way back in text without any.
+    class grapheme_boundary_tracker
+    {
+      public:
+        explicit grapheme_boundary_tracker(std::string_view text) noexcept: _text { text } {}
+
+        // Tests if the codepoint boundary at byte offset @p position is a grapheme cluster boundary.
+        bool is_boundary(size_t position) noexcept
+        {
+            if (position == 0 || position >= _text.size())
+                return true;
+
+            if (_position > position && _queryPosition != 0 && _queryPosition <= position)
+            {
+                _position = _queryPosition;
+                _state = _queryState;
+            }
+
+            // Progress of previous queries can be reused if they did not go past position.
+            auto const processed = _position <= position ? _position : 0;
+
+            auto restart = position;
+            while (restart > processed && static_cast<uint8_t>(_text[restart - 1]) >= 0x80)
+                --restart;
+
+            if (restart > processed)
+            {
+                grapheme_process_init(static_cast<char32_t>(_text[restart - 1]), _state);
+                _position = restart;
+            }
+            else if (processed == 0)
+            {
+                auto const [codepoint, length] = decode_utf8(_text);
+                grapheme_process_init(codepoint, _state);
+                _position = length;
+            }
+
+            while (_position < position)
+            {
+                auto const [codepoint, length] = decode_utf8(_text.substr(_position));
+                (void) grapheme_process_breakable(codepoint, _state);
+                _position += length;
+            }
+
+            if (_position > position)
+                return false; // position is not at a codepoint boundary
+
+            _queryPosition = position;
+            _queryState = _state;
+
+            auto const [codepoint, length] = decode_utf8(_text.substr(position));
+            _position += length;
+            return grapheme_process_breakable(codepoint, _state);
+        }
+
+      private:
+        std::string_view _text;
+        size_t _position = 0; // byte offset up to which _state has processed the text, 0 if unset
+        grapheme_segmenter_state _state {};
+        size_t _queryPosition = 0; // byte offset of the previous query, 0 if unset
+        grapheme_segmenter_state _queryState {}; // _state as it was before processing that query
+    };
+
+    // A codepoint of the case-folded haystack, along with the byte range of the source codepoint it
+    // originates from. A source codepoint folds to count folded codepoints, this is the index-th of them.
+    struct folded_unit
+    {
+        char32_t codepoint;
+        uint8_t index;
+        uint8_t count;
+        size_t begin;
+        size_t end;
+    };
+
+    // Drop consumed folded codepoints once this many accumulated in front of the search window.
+    constexpr size_t FoldedBufferCompactionThreshold = 4096;
+
+} // namespace
+
+class casefold_searcher::context
+{
+  public:
+    explicit context(std::string_view text) noexcept: haystack { text }, boundaries { text } {}
+
+    bool is_aligned(size_t begin, size_t end) noexcept
+    {
+        return boundaries.is_boundary(begin) && boundaries.is_boundary(end);
+    }
+
+    std::string_view haystack;
+    grapheme_boundary_tracker boundaries;
+};
+
+casefold_searcher::casefold_searcher(std::string_view needle):
+    casefold_searcher(std::u32string_view(convert_to<char32_t>(needle)))
+{
+}
+
+casefold_searcher::casefold_searcher(std::u32string_view needle): _needle { casefold(needle) }
+{
+    if (std::all_of(_needle.begin(), _needle.end(), [](char32_t codepoint) { return codepoint < 0x80; }))
+        std::transform(_needle.begin(), _needle.end(), std::back_inserter(_asciiNeedle), [](char32_t codepoint) {
+            return static_cast<char>(codepoint);
+        });
+
+    // Horspool bad character shifts. Folded codepoints sharing their lowest byte share a slot,
+    // which keeps the table small and only ever makes shifts shorter, never unsafe.
+    auto const length = _needle.size();
+    _shift.fill(length);
+    for (size_t i = 0; i + 1 < length; ++i)
+        _shift[_needle[i] & 0xFF] = length - 1 - i;
+}
+
+std::optional<search_match> casefold_searcher::find(std::string_view haystack, size_t start) const
+{
+    auto searchContext = context(haystack);
+    return find(searchContext, start);
+}
+
+std::vector<search_match> casefold_searcher::find_all(std::string_view haystack) const
+{
+    auto matches = std::vector<search_match> {};
+    auto searchContext = context(haystack);
+    auto start = size_t { 0 };
+    while (auto const match = find(searchContext, start))
+    {
+        matches.push_back(*match);
+        start = match->offset + match->length;
+    }
+    return matches;
+}
+
+std::optional<search_match> casefold_searcher::find(context& context, size_t start) const
+{
+    if (_needle.empty() || start >= context.haystack.size())
+        return std::nullopt;
+
+    if (!_asciiNeedle.empty())
+        return find_ascii(context, start);
+
+    return find_folded(context, start);
+}
+
+std::optional<size_t> casefold_searcher::match_at(std::string_view haystack, size_t start) const noexcept
+{
+    auto decode = decoder<char> {};
+    auto i = start;
+    auto k = size_t { 0 };
+    while (k < _needle.size())
+    {
+        if (i == haystack.size())
+            return std::nullopt;
+
+        auto const decoded = decode(static_cast<uint8_t>(haystack[i++]));
+        if (!decoded)
+            continue;
+
+        auto const mapping = full_casefold(*decoded);
+        if (mapping.is_identity())
+        {
+            if (*decoded != _needle[k++])
+                return std::nullopt;
+            continue;
+        }
+
+        // The needle must not end within the expansion of a single codepoint.
+        for (auto const folded: mapping.view())
+            if (k == _needle.size() || folded != _needle[k++])
+                return std::nullopt;
+    }
+    return i;
+}
+
+std::optional<search_match> casefold_searcher::find_ascii(context& context, size_t start) const
+{
+    auto const haystack = context.haystack;
+    auto const length = _asciiNeedle.size();
+
+    auto const tryMatchAt = [&](size_t position, std::optional<size_t> end) -> std::optional<search_match> {
+        if (end && context.is_aligned(position, *end))
+            return search_match { position, *end - position };
+        return std::nullopt;
+    };
+
+    for (auto position = start; position < haystack.size(); ++position)
+    {
+        position += detail::find_ascii_casefold_candidate(
+            haystack.data() + position, haystack.size() - position, _asciiNeedle.front());
+        if (position == haystack.size())
+            break;
+
+        auto const byte = static_cast<uint8_t>(haystack[position]);
+        if (byte >= 0x80)
+        {
+            // Skip continuation bytes, and try lead bytes as their codepoint might fold to ASCII.
+            if ((byte & 0xC0) != 0x80)
+                if (auto const match = tryMatchAt(position, match_at(haystack, position)); match)
+                    return match;
+            continue;
+        }
+
+        auto const window = std::min(length, haystack.size() - position);
+        auto const common = detail::ascii_casefold_common_prefix(haystack.data() + position, _asciiNeedle.data(), window);
+        if (common == length)
+        {
+            if (auto const match = tryMatchAt(position, position + length); match)
+                return match;
+        }
+        else if (common < window && static_cast<uint8_t>(haystack[position + common]) >= 0x80)
+        {
+            if (auto const match = tryMatchAt(position, match_at(haystack, position)); match)
+                return match;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<search_match> casefold_searcher::find_folded(context& context, size_t start) const
+{
+    auto const haystack = context.haystack;
+    auto const length = _needle.size();
+
+    auto units = std::vector<folded_unit> {};
+    auto decode = decoder<char> {};
+    auto input = start;
+
+    // Appends folded codepoints of the haystack until there are at least @p count, or the haystack is exhausted.
+    auto const fill = [&](size_t count) {
+        while (units.size() < count && input < haystack.size())
+        {
+            auto const begin = decode.expectedLength ? input - decode.currentLength : input;
+            auto const decoded = decode(static_cast<uint8_t>(haystack[input++]));
+            if (!decoded)
+                continue;
+
+            auto const mapping = full_casefold(*decoded);
+            if (mapping.is_identity())
+            {
+                units.push_back(folded_unit { *decoded, 0, 1, begin, input });
+                continue;
+            }
+            for (uint8_t i = 0; i < mapping.length; ++i)
+                units.push_back(folded_unit { mapping.codepoints[i], i, mapping.length, begin, input });
+        }
+        return units.size() >= count;
+    };
+
+    auto position = size_t { 0 };
+    while (fill(position + length))
+    {
+        auto k = length;
+        while (k > 0 && units[position + k - 1].codepoint == _needle[k - 1])
+            --k;
+
+        auto const& first = units[position];
+        auto const& last = units[position + length - 1];
+        if (k == 0 && first.index == 0 && last.index + 1 == last.count && context.is_aligned(first.begin, last.end))
+            return search_match { first.begin, last.end - first.begin };
+
+        position += _shift[last.codepoint & 0xFF];
+
+        if (position >= FoldedBufferCompactionThreshold)
+        {
+            units.erase(units.begin(), units.begin() + static_cast<std::ptrdiff_t>(position));
+            position = 0;
+        }
+    }
+
+    return std::nullopt;
+}
+
+} // namespace unicode
@@ -0,0 +1,74 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace unicode
+{
+
+/// Byte range of a match within a UTF-8 text.
+struct search_match
+{
+    size_t offset = 0;
+    size_t length = 0;
+
+    constexpr bool operator==(search_match const&) const noexcept = default;
+};
+
+/// Case-insensitive substring search over UTF-8 text.
+///
+/// The needle is case-folded (full case folding) once at construction, the haystack is searched
+/// directly without materializing its case folding. A match is a byte range of the haystack whose
+/// case folding equals the folded needle and that starts and ends at grapheme cluster boundaries.
+/// That is, "e" does not match within "é", and "s" does not match half of "ß" (which folds to "ss").
+///
+/// Needles that fold to ASCII only are searched with a SIMD prefilter on their first byte,
+/// all others with a Boyer-Moore-Horspool search over the case-folded codepoints of the haystack.
+/// An empty needle matches nothing.
+class casefold_searcher
+{
+  public:
+    explicit casefold_searcher(std::string_view needle);
+    explicit casefold_searcher(std::u32string_view needle);
+
+    /// Returns the first match starting at or after byte offset @p start,
+    /// which must be at a codepoint boundary.
+    [[nodiscard]] std::optional<search_match> find(std::string_view haystack, size_t start = 0) const;
+
+    /// Returns all non-overlapping matches in @p haystack, in order.
+    [[nodiscard]] std::vector<search_match> find_all(std::string_view haystack) const;
+
+    /// Returns the case-folded needle.
+    [[nodiscard]] std::u32string_view folded_needle() const noexcept { return _needle; }
+
+  private:
+    class context;
+
+    [[nodiscard]] std::optional<search_match> find(context& context, size_t start) const;
+    [[nodiscard]] std::optional<search_match> find_ascii(context& context, size_t start) const;
+    [[nodiscard]] std::optional<search_match> find_folded(context& context, size_t start) const;
+    [[nodiscard]] std::optional<size_t> match_at(std::string_view haystack, size_t start) const noexcept;
+
+    std::u32string _needle;
+    std::string _asciiNeedle;          // the folded needle if it is ASCII only, empty otherwise
+    std::array<size_t, 256> _shift {}; // Horspool shifts, indexed by the lowest byte of a folded codepoint
+};
+
+} // namespace unicode
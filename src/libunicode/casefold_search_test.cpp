@@ -0,0 +1,173 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/case_mapping.h>
+#include <libunicode/casefold_search.h>
+#include <libunicode/convert.h>
+#include <libunicode/grapheme_segmenter.h>
+#include <libunicode/test_random_text.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace unicode;
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+
+// Brute-force reference: the first grapheme cluster aligned byte range whose case folding equals the needle's.
+std::optional<search_match> reference_find(std::string_view haystack, std::string_view needle, size_t start)
+{
+    auto boundaries = std::vector<size_t> {};
+    auto state = grapheme_segmenter_state {};
+    auto decode = decoder<char> {};
+    auto first = true;
+    for (size_t i = 0; i < haystack.size();)
+    {
+        auto const begin = i;
+        auto decoded = std::optional<char32_t> {};
+        while (i < haystack.size() && !decoded)
+            decoded = decode(static_cast<uint8_t>(haystack[i++]));
+        if (!decoded)
+            break;
+        if (first)
+            grapheme_process_init(*decoded, state);
+        if (first || grapheme_process_breakable(*decoded, state))
+            boundaries.push_back(begin);
+        first = false;
+    }
+    boundaries.push_back(haystack.size());
+
+    auto const foldedNeedle = casefold(needle);
+    if (foldedNeedle.empty())
+        return std::nullopt;
+
+    // Case folding is context free, so the folding of a range is the concatenation of its clusters' foldings.
+    auto clusters = std::vector<std::string> {};
+    for (size_t i = 0; i + 1 < boundaries.size(); ++i)
+        clusters.push_back(casefold(haystack.substr(boundaries[i], boundaries[i + 1] - boundaries[i])));
+
+    for (size_t b = 0; b < clusters.size(); ++b)
+    {
+        if (boundaries[b] < start)
+            continue;
+        auto folded = std::string {};
+        for (size_t e = b; e < clusters.size() && folded.size() < foldedNeedle.size(); ++e)
+        {
+            folded += clusters[e];
+            if (folded == foldedNeedle)
+                return search_match { boundaries[b], boundaries[e + 1] - boundaries[b] };
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+TEST_CASE("casefold_search.ascii", "[casefold_search]")
+{
+    auto const searcher = casefold_searcher("content-TYPE"sv);
+    CHECK(searcher.folded_needle() == U"content-type");
+
+    CHECK(searcher.find("Content-Type: text/html"sv) == search_match { 0, 12 });
+    CHECK(searcher.find("X-Content-Type-Options: nosniff"sv) == search_match { 2, 12 });
+    CHECK(searcher.find("Content-Length: 42"sv) == std::nullopt);
+    CHECK(searcher.find("Content-Type"sv, 1) == std::nullopt);
+
+    // Match beyond the first SIMD blocks.
+    auto const haystack = std::string(300, '-') + "CONTENT-type";
+    CHECK(searcher.find(haystack) == search_match { 300, 12 });
+
+    CHECK(casefold_searcher(""sv).find("abc"sv) == std::nullopt);
+}
+
+TEST_CASE("casefold_search.full_casefold", "[casefold_search]")
+{
+    // KELVIN SIGN folds to ASCII k.
+    CHECK(casefold_searcher("kelvin"sv).find("273 \u212Aelvin"sv) == search_match { 4, 8 });
+
+    // ß folds to ss, in the needle and in the haystack.
+    CHECK(casefold_searcher("STRASSE"sv).find("Die Straße"sv) == search_match { 4, 7 });
+    CHECK(casefold_searcher("straße"sv).find("DIE STRASSE"sv) == search_match { 4, 7 });
+    CHECK(casefold_searcher("ss"sv).find("ß"sv) == search_match { 0, 2 });
+    CHECK(casefold_searcher("s"sv).find("ß"sv) == std::nullopt);
+
+    // Non-ASCII needle (Horspool path).
+    CHECK(casefold_searcher("ΩΜΕΓΑ"sv).find("alpha ωμεγα"sv) == search_match { 6, 10 });
+    CHECK(casefold_searcher("ωμεγα"sv).find("ΩΜΕΓ"sv) == std::nullopt);
+
+    // Long non-ASCII haystack, exceeding the folded codepoint buffer.
+    auto haystack = std::string {};
+    for (int i = 0; i < 5000; ++i)
+        haystack += "Ωμ";
+    haystack += "ΩΜΕΓΑ";
+    CHECK(casefold_searcher("ωμεγα"sv).find(haystack) == search_match { 20000, 10 });
+}
+
+TEST_CASE("casefold_search.grapheme_boundaries", "[casefold_search]")
+{
+    auto const e = casefold_searcher("E"sv);
+    CHECK(e.find("cafe\u0301"sv) == std::nullopt); // e + COMBINING ACUTE ACCENT
+    CHECK(e.find("cafe\u0301 ola"sv) == std::nullopt);
+    CHECK(e.find("cafe\u0301 olE"sv) == search_match { 9, 1 });
+
+    // Regional indicator pairs: DE only matches at a pair boundary.
+    auto const flag = casefold_searcher("\U0001F1E9\U0001F1EA"sv);
+    CHECK(flag.find("\U0001F1FA\U0001F1F8\U0001F1E9\U0001F1EA"sv) == search_match { 8, 8 });
+    CHECK(flag.find("\U0001F1F8\U0001F1E9\U0001F1EA"sv) == std::nullopt);
+    CHECK(flag.find("x\U0001F1F8\U0001F1E9\U0001F1EA"sv) == std::nullopt);
+}
+
+TEST_CASE("casefold_search.find_all", "[casefold_search]")
+{
+    auto const matches = casefold_searcher("ab"sv).find_all("AB ab aB Ab a\u0301b ab\u0301"sv);
+    CHECK(matches == std::vector<search_match> { { 0, 2 }, { 3, 2 }, { 6, 2 }, { 9, 2 } });
+
+    CHECK(casefold_searcher("中"sv).find_all("中中\u0301中"sv) == std::vector<search_match> { { 0, 3 }, { 8, 3 } });
+}
+
+TEST_CASE("casefold_search.find_all_without_ascii", "[casefold_search]")
+{
+    // Each match's begin is tested after the end of the match before. Without any ASCII in the
+    // haystack to restart segmentation at, this must not rescan it from the beginning every time.
+    auto haystack = std::string {};
+    for (size_t i = 0; i < 50000; ++i)
+        haystack += "中";
+
+    auto const matches = casefold_searcher("中"sv).find_all(haystack);
+    REQUIRE(matches.size() == 50000);
+    CHECK(matches.back() == search_match { 3 * 49999, 3 });
+}
+
+TEST_CASE("casefold_search.reference", "[casefold_search]")
+{
+    auto const alphabet = std::array {
+        "a"sv, "A"sv, "s"sv, "S"sv, "ß"sv, "k"sv, "\u212A"sv, "e"sv, "\u0301"sv, "é"sv, "É"sv, "ﬃ"sv, "f"sv, "i"sv, " "sv,
+        "Ω"sv, "ω"sv, "\U0001F1E9"sv, "\U0001F1EA"sv, "\u200D"sv, "\U0001F600"sv,
+    };
+
+    auto randomText = test::random_text_generator { alphabet };
+    for (int iteration = 0; iteration < 3000; ++iteration)
+    {
+        auto const haystack = randomText(39);
+        auto const needle = randomText(3);
+        INFO("haystack: " << haystack << ", needle: " << needle);
+        CHECK(casefold_searcher(needle).find(haystack) == reference_find(haystack, needle, 0));
+    }
+}
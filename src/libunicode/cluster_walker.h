@@ -0,0 +1,118 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <libunicode/codepoint_properties.h>
+#include <libunicode/grapheme_segmenter.h>
+#include <libunicode/scan.h>
+#include <libunicode/utf8.h>
+#include <libunicode/width.h>
+
+#include <algorithm>
+#include <string_view>
+#include <variant>
+
+namespace unicode::detail
+{
+
+/// Length of the run of printable US-ASCII (U+0020..U+007E) at the start of @p text.
+inline size_t printable_ascii_prefix(std::string_view text) noexcept
+{
+    auto const run = text.substr(0, scan_for_text_ascii(text, text.size()));
+    return std::min(run.find('\x7F'), run.size()); // DEL is zero columns wide
+}
+
+/// Walks the grapheme clusters of UTF-8 text, measuring them as measure_utf8_text() does.
+///
+/// @p onCluster is called as onCluster(start, end, column, width) with the byte range of each
+/// cluster, except for the inner characters of runs of printable US-ASCII, which are handed
+/// over in bulk as onAsciiRun(start, count, column), as each of them is a one-column cluster
+/// of its own. Either returning true stops the walk.
+///
+/// @return true if the walk was stopped, false if it reached the end of the text.
+template <typename OnCluster, typename OnAsciiRun>
+bool walk_clusters(std::string_view utf8Text, OnCluster onCluster, OnAsciiRun onAsciiRun) noexcept
+{
+    auto segmenterState = grapheme_segmenter_state {};
+    auto cluster = grapheme_cluster_width_accumulator {};
+    auto clusterStart = size_t { 0 };
+    auto column = size_t { 0 };
+    auto isClusterOpen = false;
+
+    auto const closeCluster = [&](size_t end) noexcept {
+        if (!isClusterOpen)
+            return false;
+        auto const width = static_cast<size_t>(cluster.width());
+        if (onCluster(clusterStart, end, column, width))
+            return true;
+        column += width;
+        cluster.reset();
+        isClusterOpen = false;
+        return false;
+    };
+
+    // Feeds the codepoint starting at byte @p start. With @p opensCluster set, it begins a new
+    // cluster regardless of what precedes it.
+    auto const feed = [&](char32_t codepoint, size_t start, bool opensCluster) noexcept {
+        auto const properties = codepoint_properties::get(codepoint);
+        if (!isClusterOpen || opensCluster)
+        {
+            if (closeCluster(start))
+                return true;
+            grapheme_process_init(codepoint, properties, segmenterState);
+            clusterStart = start;
+            isClusterOpen = true;
+        }
+        else if (grapheme_process_breakable(codepoint, properties, segmenterState))
+        {
+            if (closeCluster(start))
+                return true;
+            clusterStart = start;
+            isClusterOpen = true;
+        }
+        cluster.push(codepoint, properties);
+        return false;
+    };
+
+    auto input = utf8Text.data();
+    auto const end = utf8Text.data() + utf8Text.size();
+    while (input != end)
+    {
+        auto const start = static_cast<size_t>(input - utf8Text.data());
+        if (auto const asciiRun = printable_ascii_prefix(std::string_view(input, static_cast<size_t>(end - input)));
+            asciiRun > 2)
+        {
+            // The first character may still join the cluster before it, and the last may be the
+            // base of a cluster continuing after the run. Everything in between stands alone.
+            if (feed(static_cast<char32_t>(*input), start, false) || closeCluster(start + 1)
+                || onAsciiRun(start + 1, asciiRun - 2, column))
+                return true;
+            column += asciiRun - 2;
+            if (feed(static_cast<char32_t>(input[asciiRun - 1]), start + asciiRun - 1, true))
+                return true;
+            input += asciiRun;
+            continue;
+        }
+
+        // Invalid or truncated sequences are measured as U+FFFD.
+        auto const [codepoint, length] = decode_utf8(std::string_view(input, static_cast<size_t>(end - input)));
+        input += length;
+        if (feed(codepoint, start, false))
+            return true;
+    }
+
+    return closeCluster(utf8Text.size());
+}
+
+} // namespace unicode::detail
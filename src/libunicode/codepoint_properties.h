@@ -36,6 +36,11 @@ struct LIBUNICODE_PACKED codepoint_properties
     Age age = Age::Unassigned;
     Indic_Conjunct_Break indic_conjunct_break = Indic_Conjunct_Break::None;
     Word_Break word_break = Word_Break::Other;
+    Vertical_Orientation vertical_orientation = Vertical_Orientation::Rotated;
+
+    /// Id of the codepoint's distinct Script_Extensions set, or 0 if it has none.
+    /// Its scripts are given by script_extensions_bitset() (see ucd.h).
+    uint8_t script_extensions_id = 0;
 
     static uint8_t constexpr FlagEmoji = 0x01;                // NOLINT(readability-identifier-naming)
     static uint8_t constexpr FlagEmojiPresentation = 0x02;    // NOLINT(readability-identifier-naming)
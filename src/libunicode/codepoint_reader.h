@@ -0,0 +1,99 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <libunicode/case_mapping.h>
+#include <libunicode/convert.h>
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace unicode::detail
+{
+
+// Readers yield the codepoints of a text one at a time, as next() returning std::nullopt at its end,
+// so that comparing, hashing and normalizing can stop early without materializing the text in UTF-32.
+// overflowed() tells whether a reader had to give up early (see lazy_decomposition in normalization.cpp).
+//
+// Invalid UTF-8 is dropped byte by byte, as convert_to<char32_t>() does. Functions that fall back to
+// converting the whole text thus see the same codepoints as the reader would have yielded.
+
+/// Reads the codepoints of a UTF-32 string.
+struct u32_codepoint_reader
+{
+    std::u32string_view text;
+    size_t position = 0;
+
+    [[nodiscard]] std::optional<char32_t> next() noexcept
+    {
+        if (position == text.size())
+            return std::nullopt;
+        return text[position++];
+    }
+
+    [[nodiscard]] static constexpr bool overflowed() noexcept { return false; }
+};
+
+/// Reads the codepoints of a UTF-8 string, dropping invalid sequences like convert_to<char32_t>() does.
+struct utf8_codepoint_reader
+{
+    std::string_view text;
+    size_t position = 0;
+    decoder<char> decode {};
+
+    [[nodiscard]] std::optional<char32_t> next() noexcept
+    {
+        while (position < text.size())
+            if (auto const cp = decode(static_cast<uint8_t>(text[position++])); cp.has_value())
+                return cp;
+        return std::nullopt;
+    }
+
+    [[nodiscard]] static constexpr bool overflowed() noexcept { return false; }
+};
+
+/// Applies full case folding to the codepoints of another reader.
+template <typename Source>
+class casefold_reader
+{
+  public:
+    explicit casefold_reader(Source source) noexcept: _source(std::move(source)) {}
+
+    [[nodiscard]] std::optional<char32_t> next() noexcept
+    {
+        if (_position < _folded.length)
+            return _folded.codepoints[_position++];
+
+        auto const cp = _source.next();
+        if (!cp.has_value())
+            return std::nullopt;
+
+        _folded = full_casefold(*cp);
+        _position = 0;
+        if (_folded.is_identity())
+            return cp;
+        return _folded.codepoints[_position++];
+    }
+
+    [[nodiscard]] bool overflowed() const noexcept { return _source.overflowed(); }
+
+  private:
+    Source _source;
+    case_mapping_result _folded {};
+    uint8_t _position = 0;
+};
+
+} // namespace unicode::detail
@@ -33,4 +33,16 @@ size_t convert_utf8_to_utf16(char const* input, size_t inputSize, char16_t* outp
     return convert_utf8_to_utf16_simd<128>(input, inputSize, output);
 }
 
+size_t count_leading_bytes_below(char const* input, size_t inputSize, uint8_t limit) noexcept
+{
+#if (defined(LIBUNICODE_USE_STD_SIMD) || defined(LIBUNICODE_USE_INTRINSICS)) && (defined(__x86_64__) || defined(_M_AMD64))
+    static auto const simdSize = max_simd_size();
+    if (simdSize == 512)
+        return count_leading_bytes_below_512(input, inputSize, limit);
+    if (simdSize == 256)
+        return count_leading_bytes_below_256(input, inputSize, limit);
+#endif
+    return count_leading_bytes_below_simd<128>(input, inputSize, limit);
+}
+
 } // namespace unicode::detail
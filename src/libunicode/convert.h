@@ -326,6 +326,13 @@ namespace detail // {{{
     size_t convert_utf8_to_utf32_512(char const* input, size_t inputSize, char32_t* output) noexcept;
     size_t convert_utf8_to_utf16_256(char const* input, size_t inputSize, char16_t* output) noexcept;
     size_t convert_utf8_to_utf16_512(char const* input, size_t inputSize, char16_t* output) noexcept;
+
+    // Returns the number of leading bytes whose unsigned value is below @p limit (defined in convert.cpp).
+    // With limit 0x80 this is the length of the ASCII prefix; higher limits accept all codepoints
+    // whose UTF-8 lead byte is below @p limit (e.g. 0xCC accepts everything below U+0300).
+    size_t count_leading_bytes_below(char const* input, size_t inputSize, uint8_t limit) noexcept;
+    size_t count_leading_bytes_below_256(char const* input, size_t inputSize, uint8_t limit) noexcept;
+    size_t count_leading_bytes_below_512(char const* input, size_t inputSize, uint8_t limit) noexcept;
 } // namespace detail
 
 /// @p _input with element type @p S to the appropricate type of @p _output.
@@ -14,4 +14,9 @@ size_t convert_utf8_to_utf16_256(char const* input, size_t inputSize, char16_t*
     return convert_utf8_to_utf16_simd<256>(input, inputSize, output);
 }
 
+size_t count_leading_bytes_below_256(char const* input, size_t inputSize, uint8_t limit) noexcept
+{
+    return count_leading_bytes_below_simd<256>(input, inputSize, limit);
+}
+
 } // namespace unicode::detail
@@ -14,4 +14,9 @@ size_t convert_utf8_to_utf16_512(char const* input, size_t inputSize, char16_t*
     return convert_utf8_to_utf16_simd<512>(input, inputSize, output);
 }
 
+size_t count_leading_bytes_below_512(char const* input, size_t inputSize, uint8_t limit) noexcept
+{
+    return count_leading_bytes_below_simd<512>(input, inputSize, limit);
+}
+
 } // namespace unicode::detail
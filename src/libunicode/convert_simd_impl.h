@@ -233,4 +233,60 @@ size_t convert_utf8_to_utf16_simd(char const* input, size_t inputSize, char16_t*
     return static_cast<size_t>(dst - output);
 }
 
+// =====================================================================================
+// Leading byte range scan
+// =====================================================================================
+
+/// Counts the leading bytes of @p input whose (unsigned) value is strictly below @p limit.
+///
+/// Whole blocks of SimdBitWidth / 8 bytes are accepted at once; the block containing the
+/// first offending byte is finished off by the scalar tail.
+///
+/// @param input     Pointer to the input bytes.
+/// @param inputSize Number of input bytes.
+/// @param limit     Exclusive upper bound for accepted byte values.
+/// @return Number of leading bytes below @p limit.
+template <size_t SimdBitWidth>
+size_t count_leading_bytes_below_simd(char const* input, size_t inputSize, uint8_t limit) noexcept
+{
+    [[maybe_unused]] constexpr int simd_size = SimdBitWidth / 8;
+    auto const* src = reinterpret_cast<uint8_t const*>(input);
+    auto const* src_end = src + inputSize;
+
+    if (limit == 0)
+        return 0;
+
+#if defined(USE_STD_SIMD_CONVERT)
+    while (src + simd_size <= src_end)
+    {
+        auto batch = convert_stdx::fixed_size_simd<uint8_t, simd_size> {};
+        batch.copy_from(src, convert_stdx::element_aligned);
+        if (convert_stdx::any_of(batch >= limit))
+            break;
+        src += simd_size;
+    }
+#elif defined(LIBUNICODE_USE_INTRINSICS)
+    #if defined(__aarch64__) || defined(_M_ARM64)
+    static_assert(SimdBitWidth == 128, "ARM64 NEON only supports 128-bit SIMD");
+    #endif
+    // The intrinsics only provide signed byte comparison, so both sides are biased by 0x80:
+    // (x >= limit) <=> ((x ^ 0x80) > ((limit - 1) ^ 0x80)) for signed bytes.
+    using simd = intrinsics<SimdBitWidth>;
+    auto const bias = simd::set1_epi8(-128);
+    auto const biased_max = simd::set1_epi8(static_cast<signed char>((limit - 1) ^ 0x80));
+    while (src + simd_size <= src_end)
+    {
+        auto const batch = simd::xor_vec(simd::load(reinterpret_cast<char const*>(src)), bias);
+        if (simd::to_unsigned(simd::greater(batch, biased_max)))
+            break;
+        src += simd_size;
+    }
+#endif
+
+    while (src < src_end && *src < limit)
+        ++src;
+
+    return static_cast<size_t>(src - reinterpret_cast<uint8_t const*>(input));
+}
+
 } // namespace unicode::detail
@@ -335,6 +335,27 @@ TEST_CASE("convert.simd.utf8_to_utf32_string_returning", "[convert][simd]")
     CHECK(result == U"Hello, World!");
 }
 
+TEST_CASE("convert.simd.count_leading_bytes_below", "[convert][simd]")
+{
+    using unicode::detail::count_leading_bytes_below;
+
+    auto const text = std::string(100, 'a') + "\xC3\xBC" + std::string(100, 'b') + "\xCC\x81";
+    CHECK(count_leading_bytes_below(text.data(), text.size(), 0x80) == 100);
+    CHECK(count_leading_bytes_below(text.data(), text.size(), 0xCC) == 202);
+    CHECK(count_leading_bytes_below(text.data(), text.size(), 0xFF) == text.size());
+    CHECK(count_leading_bytes_below(text.data(), text.size(), 0) == 0);
+    CHECK(count_leading_bytes_below(text.data(), 0, 0x80) == 0);
+
+    // Offending byte at every position within and around a 64 byte block.
+    for (size_t i = 0; i < 130; ++i)
+    {
+        auto input = std::string(130, 'x');
+        input[i] = '\x80';
+        CHECK(count_leading_bytes_below(input.data(), input.size(), 0x80) == i);
+        CHECK(count_leading_bytes_below(input.data(), input.size(), 0x81) == input.size());
+    }
+}
+
 TEST_CASE("convert.utf8.incremental_decode", "[utf8]")
 {
     auto constexpr values = string_view {
@@ -16,6 +16,7 @@
 #include <libunicode/emoji_segmenter.h>
 #include <libunicode/ucd.h>
 
+#include <array>
 #include <cassert>
 #include <iostream>
 
@@ -108,6 +109,34 @@ namespace
 #include "emoji_presentation_scanner.c"
 } // namespace
 
+namespace detail
+{
+    size_t skip_non_emoji(char32_t const* text, size_t size) noexcept
+    {
+        // Only a handful of Latin-1 codepoints (digits, '#', '*', U+00A9, U+00AE) take part in emoji
+        // sequences, so plain Latin text is skipped without going through the property tables.
+        static auto const latin1Candidates = []() {
+            auto candidates = std::array<bool, 0x100> {};
+            for (char32_t codepoint = 0; codepoint < candidates.size(); ++codepoint)
+                candidates[codepoint] = codepoint_properties::get(codepoint).emoji_segmentation_category
+                                        != EmojiSegmentationCategory::Invalid;
+            return candidates;
+        }();
+
+        auto i = size_t { 0 };
+        while (i < size)
+        {
+            auto const codepoint = text[i];
+            if (codepoint < 0x100 ? latin1Candidates[codepoint]
+                                  : codepoint_properties::get(codepoint).emoji_segmentation_category
+                                        != EmojiSegmentationCategory::Invalid)
+                break;
+            ++i;
+        }
+        return i;
+    }
+} // namespace detail
+
 emoji_segmenter::emoji_segmenter(char32_t const* buffer, size_t size) noexcept: buffer_ { buffer }, size_ { size }
 {
     if (size_)
@@ -156,6 +185,14 @@ bool emoji_segmenter::consume(out<size_t> size, out<PresentationStyle> emoji) no
 
 size_t emoji_segmenter::consume_once()
 {
+    // A codepoint without an emoji segmentation category neither starts nor continues an emoji sequence,
+    // and the scanner would merely return it as a text token of its own. Skip all of them at once.
+    if (auto const skipped = detail::skip_non_emoji(buffer_ + currentCursorEnd_, size_ - currentCursorEnd_))
+    {
+        isNextEmoji_ = false;
+        return currentCursorEnd_ + skipped;
+    }
+
     auto const i = RagelIterator(buffer_, size_, currentCursorEnd_);
     auto const e = RagelIterator(buffer_, size_, size_);
     auto const o = scan_emoji_presentation(i, e, &isNextEmoji_);
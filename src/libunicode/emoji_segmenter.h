@@ -49,6 +49,13 @@ enum class EmojiSegmentationCategory : int8_t
     TagTerm = 15,
 };
 
+namespace detail
+{
+    /// @returns the number of leading codepoints in @p text that have no emoji segmentation category
+    ///          and thus can not be part of any emoji sequence.
+    size_t skip_non_emoji(char32_t const* text, size_t size) noexcept;
+} // namespace detail
+
 /**
  * emoji_segmenter API for segmenting emojis into text-emoji and emoji-emoji presentations.
  *
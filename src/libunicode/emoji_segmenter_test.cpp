@@ -139,3 +139,19 @@ TEST_CASE("emoji_segmenter.mixed_complex", "[emoji_segmenter]")
             { U")合!", PresentationStyle::Text },                                          // Kanji text
         });
 }
+
+TEST_CASE("emoji_segmenter.skip_non_emoji", "[emoji_segmenter]")
+{
+    CHECK(unicode::detail::skip_non_emoji(U"Hello, Wörld中!", 14) == 14);
+    CHECK(unicode::detail::skip_non_emoji(U"abc1⃣", 5) == 3);
+    CHECK(unicode::detail::skip_non_emoji(U"abc©", 4) == 3);
+    CHECK(unicode::detail::skip_non_emoji(U"ab\U0001F600", 3) == 2);
+
+    // Digits are keycap bases and may only be skipped by the scanner.
+    test_segments(__LINE__,
+                  {
+                      { U"Plain text, 12 words or so, and some more of it.", PresentationStyle::Text },
+                      { U"\U0001F600", PresentationStyle::Emoji },
+                      { U" and more text #⃣", PresentationStyle::Text },
+                  });
+}
@@ -0,0 +1,302 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/codepoint_properties.h>
+#include <libunicode/fused_run_segmenter.h>
+#include <libunicode/utf8.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace unicode
+{
+
+namespace detail
+{
+    /// The emoji presentation scanner's view of the text, reading each codepoint's category from the
+    /// fused run segmenter rather than looking it up. Unlike emoji_segmenter's iterator, it does not
+    /// touch the category until it is dereferenced, as the scanner creates far more iterators than it reads.
+    ///
+    /// Cursors are codepoint indices. The end of UTF-8 text is not known in codepoints up front,
+    /// so the end iterator is a sentinel that compares equal to any cursor past the last codepoint.
+    template <typename Char>
+    class fused_emoji_iterator
+    {
+      public:
+        static constexpr size_t EndCursor = static_cast<size_t>(-1);
+
+        fused_emoji_iterator(fused_run_scanner<Char>* segmenter, size_t cursor) noexcept:
+            segmenter_ { segmenter }, cursor_ { cursor }
+        {
+        }
+
+        fused_emoji_iterator() noexcept = default;
+
+        [[nodiscard]] constexpr size_t cursor() const noexcept { return cursor_; }
+
+        int operator*() const noexcept { return static_cast<int>(segmenter_->categoryAt(cursor_)); }
+
+        fused_emoji_iterator& operator++() noexcept
+        {
+            ++cursor_;
+            return *this;
+        }
+
+        fused_emoji_iterator& operator--(int) noexcept
+        {
+            --cursor_;
+            return *this;
+        }
+
+        fused_emoji_iterator operator+(long v) const noexcept
+        {
+            return { segmenter_, cursor_ + static_cast<size_t>(v) };
+        }
+
+        fused_emoji_iterator operator-(long v) const noexcept
+        {
+            assert(v < 0 || cursor_ >= static_cast<size_t>(v));
+            return { segmenter_, cursor_ - static_cast<size_t>(v) };
+        }
+
+        fused_emoji_iterator& operator=(int v) noexcept
+        {
+            assert(v >= 0);
+            cursor_ = static_cast<size_t>(v);
+            return *this;
+        }
+
+        bool operator==(fused_emoji_iterator const& rhs) const noexcept
+        {
+            if (cursor_ == rhs.cursor_)
+                return true;
+            if (rhs.cursor_ == EndCursor)
+                return segmenter_->endsAt(cursor_);
+            if (cursor_ == EndCursor)
+                return rhs.segmenter_->endsAt(rhs.cursor_);
+            return false;
+        }
+
+        bool operator!=(fused_emoji_iterator const& rhs) const noexcept { return !(*this == rhs); }
+
+      private:
+        fused_run_scanner<Char>* segmenter_ = nullptr;
+        size_t cursor_ = 0;
+    };
+} // namespace detail
+
+namespace
+{
+    // The scanner is instantiated once per input encoding, each over its own iterator type.
+    namespace utf8_scanner
+    {
+        using emoji_text_iter_t = detail::fused_emoji_iterator<char>;
+
+#include "emoji_presentation_scanner.c"
+    } // namespace utf8_scanner
+
+    namespace utf32_scanner
+    {
+        using emoji_text_iter_t = detail::fused_emoji_iterator<char32_t>;
+
+#include "emoji_presentation_scanner.c"
+    } // namespace utf32_scanner
+
+    auto scan_emoji_presentation(detail::fused_emoji_iterator<char> p,
+                                 detail::fused_emoji_iterator<char> pe,
+                                 bool* isEmoji) noexcept
+    {
+        return utf8_scanner::scan_emoji_presentation(p, pe, isEmoji);
+    }
+
+    auto scan_emoji_presentation(detail::fused_emoji_iterator<char32_t> p,
+                                 detail::fused_emoji_iterator<char32_t> pe,
+                                 bool* isEmoji) noexcept
+    {
+        return utf32_scanner::scan_emoji_presentation(p, pe, isEmoji);
+    }
+} // namespace
+
+template <typename Char>
+detail::fused_run_scanner<Char>::fused_run_scanner(Char const* text, size_t size, bool vertical) noexcept:
+    text_ { text }, size_ { size }, vertical_ { vertical }
+{
+}
+
+template <typename Char>
+auto detail::fused_run_scanner<Char>::decodeAt(size_t offset) const noexcept -> decoded_codepoint
+{
+    if constexpr (sizeof(Char) == 4)
+        return { static_cast<char32_t>(text_[offset]), 1 };
+    else
+    {
+        auto const [codepoint, length] = decode_utf8(std::string_view(text_ + offset, size_ - offset));
+        return { codepoint, length };
+    }
+}
+
+template <typename Char>
+bool detail::fused_run_scanner<Char>::endsAt(size_t position) noexcept
+{
+    while (lookupCursor_ <= position && lookupOffset_ < size_)
+        lookupNext();
+    return lookupCursor_ <= position;
+}
+
+template <typename Char>
+EmojiSegmentationCategory detail::fused_run_scanner<Char>::categoryAt(size_t position) noexcept
+{
+    if (endsAt(position))
+        return EmojiSegmentationCategory::Invalid;
+
+    if (auto const& cached = categoryCache_[position % CategoryCacheSize]; cached.position == position)
+        return cached.category;
+
+    // Backtracked further than the cache reaches. This is only ever a second emoji lookup,
+    // the script segmentation has seen this codepoint already. The scanner never backtracks
+    // before the token it scans, so the codepoint is found walking forward from there.
+    auto offset = emojiOffset_;
+    for (auto i = emojiCursor_; i < position; ++i)
+        offset += decodeAt(offset).length;
+    return codepoint_properties::get(decodeAt(offset).codepoint).emoji_segmentation_category;
+}
+
+template <typename Char>
+void detail::fused_run_scanner<Char>::lookupNext() noexcept
+{
+    auto const position = lookupCursor_++;
+    auto const start = lookupOffset_;
+    auto const [codepoint, length] = decodeAt(start);
+    auto const properties = codepoint_properties::get(codepoint);
+    lookupOffset_ += length;
+
+    categoryCache_[position % CategoryCacheSize] = { position, properties.emoji_segmentation_category };
+
+    auto endedScript = Script::Invalid;
+    if (!scripts_.push(properties.script, properties.script_extensions_id, out(endedScript)))
+        scriptRegions_.regions.push_back({ start, endedScript });
+
+    if (vertical_)
+    {
+        auto endedOrientation = TextOrientation::Sideways;
+        if (!orientations_.push(properties.vertical_orientation, properties.grapheme_cluster_break, out(endedOrientation)))
+            orientationRegions_.regions.push_back({ start, endedOrientation });
+    }
+
+    if (lookupOffset_ == size_)
+    {
+        scriptRegions_.regions.push_back({ size_, scripts_.currentScript() });
+        if (vertical_)
+            orientationRegions_.regions.push_back({ size_, orientations_.currentOrientation() });
+    }
+}
+
+template <typename Char>
+void detail::fused_run_scanner<Char>::scanEmojiToken() noexcept
+{
+    using iterator = detail::fused_emoji_iterator<Char>;
+
+    auto const tokenStart = emojiCursor_;
+    auto isEmoji = false;
+    auto tokenEnd = tokenStart;
+
+    // Codepoints without an emoji segmentation category are text tokens of their own,
+    // so a run of them is taken as one without entering the scanner.
+    while (categoryAt(tokenEnd) == EmojiSegmentationCategory::Invalid && !endsAt(tokenEnd))
+        ++tokenEnd;
+
+    if (tokenEnd == tokenStart)
+        tokenEnd = scan_emoji_presentation(
+                       iterator(this, tokenStart), iterator(this, iterator::EndCursor), &isEmoji)
+                       .cursor();
+    auto const presentation = isEmoji ? PresentationStyle::Emoji : PresentationStyle::Text;
+
+    if (!emojiRegionOpen_)
+    {
+        emojiRegionOpen_ = true;
+        openEmojiPresentation_ = presentation;
+    }
+    else if (presentation != openEmojiPresentation_)
+    {
+        emojiRegions_.regions.push_back({ emojiOffset_, openEmojiPresentation_ });
+        openEmojiPresentation_ = presentation;
+    }
+
+    tokenEnd = std::max(tokenEnd, tokenStart + 1);
+    while (emojiCursor_ < tokenEnd && emojiOffset_ < size_)
+    {
+        emojiOffset_ += decodeAt(emojiOffset_).length;
+        ++emojiCursor_;
+    }
+
+    if (emojiOffset_ >= size_)
+    {
+        emojiRegions_.regions.push_back({ size_, openEmojiPresentation_ });
+        emojiRegionOpen_ = false;
+    }
+}
+
+template <typename Char, bool Vertical>
+bool basic_fused_run_segmenter<Char, Vertical>::consume(out<range> result)
+{
+    if (this->finished())
+        return false;
+
+    // A run is complete once the script region and the emoji region (and orientation region) it starts
+    // in are known to end. The script a run resolves to depends on its whole script region, so that
+    // region has to be scanned to its end before its first run can be returned -- just as
+    // run_segmenter does.
+    while (this->scriptRegions_.empty() || this->emojiRegions_.empty()
+           || (Vertical && this->orientationRegions_.empty()))
+    {
+        if (this->emojiOffset_ < this->size_)
+            this->scanEmojiToken();
+        else
+            (void) this->endsAt(static_cast<size_t>(-1) - 1);
+    }
+
+    auto const& script = this->scriptRegions_.front();
+    auto const& emoji = this->emojiRegions_.front();
+    auto end = std::min(script.end, emoji.end);
+
+    if constexpr (Vertical)
+    {
+        auto const& orientation = this->orientationRegions_.front();
+        end = std::min(end, orientation.end);
+        *result = range { this->offset_,
+                          end,
+                          property_tuple { script.script, emoji.presentation, orientation.orientation } };
+        if (orientation.end == end)
+            this->orientationRegions_.pop_front();
+    }
+    else
+        *result = range { this->offset_, end, property_tuple { script.script, emoji.presentation } };
+
+    this->offset_ = end;
+
+    if (script.end == end)
+        this->scriptRegions_.pop_front();
+    if (emoji.end == end)
+        this->emojiRegions_.pop_front();
+
+    return true;
+}
+
+template class detail::fused_run_scanner<char>;
+template class detail::fused_run_scanner<char32_t>;
+template class basic_fused_run_segmenter<char>;
+template class basic_fused_run_segmenter<char32_t>;
+template class basic_fused_run_segmenter<char, true>;
+template class basic_fused_run_segmenter<char32_t, true>;
+
+} // namespace unicode
@@ -0,0 +1,208 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <libunicode/emoji_segmenter.h>
+#include <libunicode/orientation_segmenter.h>
+#include <libunicode/run_segmenter.h>
+#include <libunicode/script_segmenter.h>
+#include <libunicode/support.h>
+#include <libunicode/ucd.h>
+
+#include <array>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace unicode
+{
+
+namespace detail
+{
+    template <typename Char>
+    class fused_emoji_iterator;
+
+    /// The state of basic_fused_run_segmenter that does not depend on the properties it segments by.
+    ///
+    /// Looks up every codepoint once, feeding the script segmentation (and, if enabled, the
+    /// orientation segmentation) as it goes, and scans the emoji presentation tokens on top.
+    /// The runs each of them found are queued as regions, from which consume() cuts the runs.
+    template <typename Char>
+    class fused_run_scanner
+    {
+      public:
+        fused_run_scanner(Char const* text, size_t size, bool vertical) noexcept;
+
+        [[nodiscard]] constexpr bool finished() const noexcept { return offset_ >= size_; }
+
+      protected:
+        friend class fused_emoji_iterator<Char>;
+
+        struct decoded_codepoint
+        {
+            char32_t codepoint;
+            size_t length; // in code units
+        };
+
+        /// Decodes the codepoint starting at code unit @p offset.
+        [[nodiscard]] decoded_codepoint decodeAt(size_t offset) const noexcept;
+
+        /// Returns the emoji segmentation category of the codepoint with index @p position,
+        /// looking up (and feeding into the script segmentation) every codepoint up to it not seen yet.
+        EmojiSegmentationCategory categoryAt(size_t position) noexcept;
+
+        /// Tests whether the codepoint index @p position is at (or behind) the end of the text.
+        bool endsAt(size_t position) noexcept;
+
+        /// Looks up the next codepoint not seen yet and feeds it into the script segmentation,
+        /// and into the orientation segmentation for vertical text.
+        void lookupNext() noexcept;
+
+        /// Scans the next emoji presentation token, extending or closing the open emoji region.
+        void scanEmojiToken() noexcept;
+
+        template <typename Region>
+        struct region_queue
+        {
+            std::vector<Region> regions {};
+            size_t head = 0;
+
+            [[nodiscard]] bool empty() const noexcept { return head == regions.size(); }
+            [[nodiscard]] Region const& front() const noexcept { return regions[head]; }
+
+            void pop_front() noexcept
+            {
+                if (++head == regions.size())
+                {
+                    regions.clear();
+                    head = 0;
+                }
+            }
+        };
+
+        /// A run of codepoints of one script, ending at code unit offset @c end.
+        struct script_region
+        {
+            size_t end;
+            Script script;
+        };
+
+        /// A run of codepoints of one presentation style, ending at code unit offset @c end.
+        struct emoji_region
+        {
+            size_t end;
+            PresentationStyle presentation;
+        };
+
+        /// A run of codepoints of one vertical orientation, ending at code unit offset @c end.
+        struct orientation_region
+        {
+            size_t end;
+            TextOrientation orientation;
+        };
+
+        struct cached_category
+        {
+            size_t position = static_cast<size_t>(-1);
+            EmojiSegmentationCategory category = EmojiSegmentationCategory::Invalid;
+        };
+
+        static constexpr size_t CategoryCacheSize = 64;
+
+        Char const* text_;
+        size_t size_; // in code units
+        bool vertical_;
+
+        /// Code unit offset of the next run to be returned by consume().
+        size_t offset_ = 0;
+
+        /// Every codepoint before this index has been looked up and fed into scripts_.
+        size_t lookupCursor_ = 0;
+        size_t lookupOffset_ = 0; // code unit offset of the codepoint at lookupCursor_
+        script_segmenter scripts_ { std::u32string_view {} };
+        region_queue<script_region> scriptRegions_ {};
+        orientation_segmenter orientations_ {};
+        region_queue<orientation_region> orientationRegions_ {};
+
+        /// Every codepoint before this index has been scanned into emoji presentation tokens.
+        size_t emojiCursor_ = 0;
+        size_t emojiOffset_ = 0; // code unit offset of the codepoint at emojiCursor_
+        bool emojiRegionOpen_ = false;
+        PresentationStyle openEmojiPresentation_ = PresentationStyle::Text;
+        region_queue<emoji_region> emojiRegions_ {};
+
+        std::array<cached_category, CategoryCacheSize> categoryCache_ {};
+    };
+} // namespace detail
+
+/// Segments text into runs by script and by emoji presentation in a single pass.
+///
+/// Produces exactly the runs of run_segmenter (i.e. basic_run_segmenter<script_segmenter, emoji_segmenter>),
+/// but instead of driving two independent segmenters over the text, each doing its own property
+/// lookups, every codepoint is looked up once and fed into both state machines together.
+///
+/// With @p Vertical set, it produces exactly the runs of vertical_run_segmenter instead, feeding the
+/// same lookup into the orientation segmentation as well.
+///
+/// The emoji presentation scanner needs a little lookahead and backtracking; codepoints it revisits
+/// are served from a small cache of the most recently looked up ones.
+///
+/// @p Char is either @c char32_t for UTF-32 input, or @c char for UTF-8 input. The range offsets are
+/// in code units of the input, that is, byte offsets into UTF-8 text, so that they can be handed to
+/// a shaper without transcoding the text or translating offsets. Invalid UTF-8 is segmented as U+FFFD.
+template <typename Char, bool Vertical = false>
+class basic_fused_run_segmenter: public detail::fused_run_scanner<Char>
+{
+  public:
+    using reference_segmenter = std::conditional_t<Vertical, vertical_run_segmenter, run_segmenter>;
+    using property_tuple = typename reference_segmenter::property_tuple;
+    using range = typename reference_segmenter::range;
+
+    explicit basic_fused_run_segmenter(std::basic_string_view<Char> text) noexcept:
+        basic_fused_run_segmenter(text.data(), text.size())
+    {
+    }
+
+    basic_fused_run_segmenter(Char const* text, size_t size) noexcept:
+        detail::fused_run_scanner<Char>(text, size, Vertical)
+    {
+    }
+
+    /// Splits input text into segments, such as pure text by script, emoji-emoji, or emoji-text.
+    ///
+    /// @retval true more data can be processed
+    /// @retval false end of input data has been reached.
+    bool consume(out<range> result);
+};
+
+/// Fused run segmentation over UTF-32 text.
+using fused_run_segmenter = basic_fused_run_segmenter<char32_t>;
+
+/// Run segmentation over UTF-8 text, with ranges in byte offsets.
+using utf8_run_segmenter = basic_fused_run_segmenter<char>;
+
+/// Fused run segmentation for vertical text layout over UTF-32 text.
+using fused_vertical_run_segmenter = basic_fused_run_segmenter<char32_t, true>;
+
+/// Run segmentation for vertical text layout over UTF-8 text, with ranges in byte offsets.
+using utf8_vertical_run_segmenter = basic_fused_run_segmenter<char, true>;
+
+extern template class detail::fused_run_scanner<char>;
+extern template class detail::fused_run_scanner<char32_t>;
+extern template class basic_fused_run_segmenter<char>;
+extern template class basic_fused_run_segmenter<char32_t>;
+extern template class basic_fused_run_segmenter<char, true>;
+extern template class basic_fused_run_segmenter<char32_t, true>;
+
+} // namespace unicode
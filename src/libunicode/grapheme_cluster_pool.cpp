@@ -0,0 +1,84 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/grapheme_cluster_pool.h>
+#include <libunicode/support.h>
+#include <libunicode/utf8.h>
+#include <libunicode/width.h>
+
+#include <limits>
+#include <stdexcept>
+#include <variant>
+
+namespace unicode
+{
+
+grapheme_cluster_handle grapheme_cluster_pool::intern(std::u32string_view cluster)
+{
+    return intern(cluster, grapheme_cluster_width(cluster));
+}
+
+grapheme_cluster_handle grapheme_cluster_pool::intern(std::u32string_view cluster, unsigned width)
+{
+    if (cluster.size() <= grapheme_cluster_handle::inline_capacity)
+        return grapheme_cluster_handle::make_inline(cluster, width);
+
+    auto hasher = codepoint_hasher {};
+    for (auto const codepoint: cluster)
+        hasher(codepoint);
+    auto const hash = hasher.value();
+
+    auto const [first, last] = _idsByHash.equal_range(hash);
+    for (auto i = first; i != last; ++i)
+    {
+        auto const& existing = _entries[i->second];
+        if (std::u32string_view(_arena).substr(existing.offset, existing.length) == cluster)
+            return grapheme_cluster_handle::make_interned(i->second, existing.width);
+    }
+
+    // Ids and offsets are 32 bits wide. Refuse to wrap around rather than alias other clusters.
+    constexpr auto Limit = size_t { std::numeric_limits<uint32_t>::max() };
+    if (_entries.size() >= Limit || cluster.size() > Limit - _arena.size())
+        throw std::length_error("grapheme_cluster_pool is full");
+
+    auto const id = static_cast<uint32_t>(_entries.size());
+    _entries.push_back(entry { static_cast<uint32_t>(_arena.size()), static_cast<uint32_t>(cluster.size()), width });
+    _arena.append(cluster);
+    _idsByHash.emplace(hash, id);
+    return grapheme_cluster_handle::make_interned(id, width);
+}
+
+std::u32string_view grapheme_cluster_pool::codepoints(grapheme_cluster_handle const& handle) const noexcept
+{
+    if (handle.is_inline())
+        return handle.inline_codepoints();
+
+    auto const& interned = _entries[handle.id()];
+    return std::u32string_view(_arena).substr(interned.offset, interned.length);
+}
+
+void grapheme_cluster_interner::receiveGraphemeCluster(std::string_view codepoints, size_t columnCount) noexcept
+{
+    // Decoded the way scan_text() measures it, so that invalid sequences become U+FFFD.
+    _codepoints.clear();
+    while (!codepoints.empty())
+    {
+        auto const [codepoint, length] = decode_utf8(codepoints);
+        _codepoints.push_back(codepoint);
+        codepoints.remove_prefix(length);
+    }
+
+    _receiver.receiveGraphemeCluster(_pool.intern(_codepoints, static_cast<unsigned>(columnCount)));
+}
+
+} // namespace unicode
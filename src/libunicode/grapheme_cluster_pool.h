@@ -0,0 +1,180 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <libunicode/scan.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace unicode
+{
+
+/// A grapheme cluster together with its display width, in 128 bits.
+///
+/// Clusters of up to inline_capacity codepoints are stored in the handle itself, longer ones
+/// are referred to by their id in a grapheme_cluster_pool. As a pool stores every cluster only
+/// once, two handles of the same pool compare equal if and only if their clusters are equal.
+class grapheme_cluster_handle
+{
+  public:
+    /// Maximum number of codepoints a handle holds without the help of a pool.
+    static constexpr size_t inline_capacity = 3;
+
+    /// Constructs the handle of the empty grapheme cluster.
+    constexpr grapheme_cluster_handle() noexcept = default;
+
+    /// Constructs a handle holding @p cluster inline, which must not exceed inline_capacity codepoints.
+    static constexpr grapheme_cluster_handle make_inline(std::u32string_view cluster, unsigned width) noexcept
+    {
+        auto handle = grapheme_cluster_handle {};
+        for (size_t i = 0; i < cluster.size() && i < inline_capacity; ++i)
+            handle._data[i] = cluster[i];
+        handle._meta = makeMeta(width) | (static_cast<uint32_t>(cluster.size()) << SizeShift);
+        return handle;
+    }
+
+    /// Constructs a handle referring to the cluster with the given @p id in a grapheme_cluster_pool.
+    static constexpr grapheme_cluster_handle make_interned(uint32_t id, unsigned width) noexcept
+    {
+        auto handle = grapheme_cluster_handle {};
+        handle._data[0] = static_cast<char32_t>(id);
+        handle._meta = makeMeta(width) | InternedBit;
+        return handle;
+    }
+
+    [[nodiscard]] constexpr bool is_inline() const noexcept { return !(_meta & InternedBit); }
+
+    /// Display width of the cluster, as computed by grapheme_cluster_width().
+    ///
+    /// Saturates at 65535 columns, which is far beyond any line a terminal would display.
+    [[nodiscard]] constexpr unsigned width() const noexcept { return _meta & WidthMask; }
+
+    /// Codepoints of an inline cluster. The view refers into this handle.
+    [[nodiscard]] constexpr std::u32string_view inline_codepoints() const noexcept
+    {
+        return { _data.data(), is_inline() ? (_meta >> SizeShift) & SizeMask : 0 };
+    }
+
+    /// Id of an interned cluster within its grapheme_cluster_pool.
+    [[nodiscard]] constexpr uint32_t id() const noexcept { return static_cast<uint32_t>(_data[0]); }
+
+    constexpr bool operator==(grapheme_cluster_handle const& other) const noexcept = default;
+
+  private:
+    static constexpr uint32_t WidthMask = 0xFFFF;
+    static constexpr uint32_t SizeShift = 16;
+    static constexpr uint32_t SizeMask = 0x3;
+    static constexpr uint32_t InternedBit = 0x8000'0000;
+
+    static constexpr uint32_t makeMeta(unsigned width) noexcept { return width < WidthMask ? width : WidthMask; }
+
+    std::array<char32_t, inline_capacity> _data {};
+    uint32_t _meta = 0;
+};
+
+static_assert(sizeof(grapheme_cluster_handle) == 16);
+
+/// Interns grapheme clusters, e.g. the contents of terminal cells, into grapheme_cluster_handle values.
+///
+/// Short clusters are held inline by the handle and never touch the pool. Longer ones (ZWJ emoji
+/// sequences, Indic conjuncts, stacks of combining marks) are stored once in an arena, so that all
+/// cells showing the same cluster share its codepoints. Interned clusters are never removed, so
+/// their ids stay valid for the lifetime of the pool.
+///
+/// Ids and arena offsets are 32 bits wide, which limits a pool to 2^32 - 1 codepoints in total.
+class grapheme_cluster_pool
+{
+  public:
+    /// Returns the handle of the grapheme cluster @p cluster, computing its width.
+    ///
+    /// @throws std::length_error if the pool has no room left for @p cluster (see above),
+    ///         std::bad_alloc if it cannot grow.
+    grapheme_cluster_handle intern(std::u32string_view cluster);
+
+    /// Returns the handle of the grapheme cluster @p cluster, whose @p width is already known,
+    /// e.g. from scan_text().
+    ///
+    /// @throws std::length_error if the pool has no room left for @p cluster (see above),
+    ///         std::bad_alloc if it cannot grow.
+    grapheme_cluster_handle intern(std::u32string_view cluster, unsigned width);
+
+    /// Returns the codepoints of the cluster @p handle refers to.
+    ///
+    /// The view refers into the handle for inline clusters and into the pool otherwise,
+    /// where it remains valid until the next call to intern().
+    [[nodiscard]] std::u32string_view codepoints(grapheme_cluster_handle const& handle) const noexcept;
+
+    /// Number of clusters stored in the pool, i.e. not held inline.
+    [[nodiscard]] size_t size() const noexcept { return _entries.size(); }
+
+  private:
+    struct entry
+    {
+        uint32_t offset;
+        uint32_t length;
+        unsigned width;
+    };
+
+    std::u32string _arena;
+    std::vector<entry> _entries;
+    std::unordered_multimap<uint64_t, uint32_t> _idsByHash;
+};
+
+/// Receives the output of scan_text() as grapheme cluster handles.
+class grapheme_cluster_handle_receiver
+{
+  public:
+    virtual ~grapheme_cluster_handle_receiver() = default;
+
+    virtual void receiveAsciiSequence(std::string_view codepoints) noexcept = 0;
+    virtual void receiveGraphemeCluster(grapheme_cluster_handle cluster) noexcept = 0;
+    virtual void receiveInvalidGraphemeCluster() noexcept = 0;
+};
+
+/// grapheme_cluster_receiver interning the clusters scan_text() finds into a grapheme_cluster_pool,
+/// and passing their handles on. ASCII sequences are passed on as they are.
+///
+/// The width scan_text() measured is cached in the handle, so the cluster is not measured again.
+///
+/// Interning allocates, but grapheme_cluster_receiver callbacks must not throw. Running out of
+/// memory, or out of room in the pool, while receiving a cluster therefore calls std::terminate().
+class grapheme_cluster_interner final: public grapheme_cluster_receiver
+{
+  public:
+    grapheme_cluster_interner(grapheme_cluster_pool& pool, grapheme_cluster_handle_receiver& receiver) noexcept:
+        _pool { pool }, _receiver { receiver }
+    {
+    }
+
+    void receiveAsciiSequence(std::string_view codepoints) noexcept override
+    {
+        _receiver.receiveAsciiSequence(codepoints);
+    }
+
+    void receiveGraphemeCluster(std::string_view codepoints, size_t columnCount) noexcept override;
+
+    void receiveInvalidGraphemeCluster() noexcept override { _receiver.receiveInvalidGraphemeCluster(); }
+
+  private:
+    grapheme_cluster_pool& _pool;
+    grapheme_cluster_handle_receiver& _receiver;
+    std::u32string _codepoints; // decoding buffer, kept to not allocate per cluster
+};
+
+} // namespace unicode
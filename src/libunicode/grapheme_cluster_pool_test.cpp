@@ -0,0 +1,107 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/grapheme_cluster_pool.h>
+#include <libunicode/utf8.h>
+#include <libunicode/width.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace unicode;
+
+TEST_CASE("grapheme_cluster_pool.inline", "[grapheme_cluster_pool]")
+{
+    auto pool = grapheme_cluster_pool {};
+
+    auto const empty = pool.intern(U""sv);
+    CHECK(empty == grapheme_cluster_handle {});
+    CHECK(empty.width() == 0);
+
+    // Emoji with VS16: two codepoints, held by the handle itself.
+    auto const heart = pool.intern(U"\u2764\uFE0F"sv);
+    CHECK(heart.is_inline());
+    CHECK(heart.width() == 2);
+    CHECK(pool.codepoints(heart) == U"\u2764\uFE0F"sv);
+    CHECK(heart == pool.intern(U"\u2764\uFE0F"sv));
+    CHECK(heart != pool.intern(U"\u2764"sv));
+    CHECK(pool.size() == 0);
+}
+
+TEST_CASE("grapheme_cluster_pool.interned", "[grapheme_cluster_pool]")
+{
+    auto pool = grapheme_cluster_pool {};
+
+    // Family: man, woman, girl -- five codepoints, stored in the pool.
+    auto const family = U"\U0001F468\u200D\U0001F469\u200D\U0001F467"sv;
+    auto const combining = U"e\u0301\u0302\u0303"sv;
+
+    auto const familyHandle = pool.intern(family);
+    auto const combiningHandle = pool.intern(combining);
+    CHECK_FALSE(familyHandle.is_inline());
+    CHECK(familyHandle.width() == grapheme_cluster_width(family));
+    CHECK(combiningHandle.width() == 1);
+    CHECK(familyHandle != combiningHandle);
+    CHECK(pool.size() == 2);
+
+    // Interning a cluster again yields the same handle, without storing it a second time.
+    CHECK(pool.intern(std::u32string(family)) == familyHandle);
+    CHECK(pool.size() == 2);
+
+    CHECK(pool.codepoints(familyHandle) == family);
+    CHECK(pool.codepoints(combiningHandle) == combining);
+}
+
+namespace
+{
+struct handle_collector final: public grapheme_cluster_handle_receiver
+{
+    std::string ascii;
+    std::vector<grapheme_cluster_handle> clusters;
+    size_t invalidCount = 0;
+
+    void receiveAsciiSequence(std::string_view text) noexcept override { ascii += text; }
+    void receiveGraphemeCluster(grapheme_cluster_handle cluster) noexcept override { clusters.push_back(cluster); }
+    void receiveInvalidGraphemeCluster() noexcept override { ++invalidCount; }
+};
+} // namespace
+
+TEST_CASE("grapheme_cluster_pool.scan_text", "[grapheme_cluster_pool]")
+{
+    auto const family = U"\U0001F468\u200D\U0001F469\u200D\U0001F467"sv;
+    auto const text = to_utf8(U"ab中"s + std::u32string(family) + U"é"s + std::u32string(family));
+
+    auto pool = grapheme_cluster_pool {};
+    auto collector = handle_collector {};
+    auto interner = grapheme_cluster_interner { pool, collector };
+    auto state = scan_state {};
+    auto const result = scan_text(state, text, 80, interner);
+
+    CHECK(collector.ascii == "ab");
+    REQUIRE(collector.clusters.size() == 4);
+    CHECK(pool.codepoints(collector.clusters[0]) == U"中"sv);
+    CHECK(pool.codepoints(collector.clusters[1]) == family);
+    CHECK(pool.codepoints(collector.clusters[2]) == U"é"sv);
+    CHECK(collector.clusters[1] == collector.clusters[3]);
+    CHECK(pool.size() == 1);
+
+    auto columns = collector.ascii.size();
+    for (auto const& cluster: collector.clusters)
+        columns += cluster.width();
+    CHECK(columns == result.count);
+}
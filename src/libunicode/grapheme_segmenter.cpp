@@ -13,12 +13,95 @@
  */
 #include <libunicode/utf8_grapheme_segmenter.h>
 
+#include <array>
+
 namespace unicode
 {
 
-void grapheme_process_init(char32_t nextCodepoint, grapheme_segmenter_state& state) noexcept
+namespace
 {
-    auto const Pb = codepoint_properties::get(nextCodepoint);
+    /// Outcome of the pairwise grapheme cluster boundary rules for two Grapheme_Cluster_Break values.
+    enum class pair_rule : uint8_t
+    {
+        Break,
+        NoBreak,
+        Conditional, ///< Decided by GB9c, GB11 or GB12/GB13 on the side state in grapheme_segmenter_state.
+    };
+
+    // Grapheme_Cluster_Break values are generated from the UCD; ZWJ is alphabetically last.
+    constexpr size_t GraphemeClusterBreakCount = 32;
+    static_assert(static_cast<size_t>(Grapheme_Cluster_Break::ZWJ) < GraphemeClusterBreakCount);
+
+    /// Implements the rules of https://www.unicode.org/reports/tr29/#Grapheme_Cluster_Boundary_Rules
+    /// that only depend on the Grapheme_Cluster_Break values of the two codepoints.
+    constexpr pair_rule decide_pair(Grapheme_Cluster_Break A, Grapheme_Cluster_Break B) noexcept
+    {
+        using GCB = Grapheme_Cluster_Break;
+
+        // GB3: Do not break between a CR and LF.
+        if (A == GCB::CR && B == GCB::LF)
+            return pair_rule::NoBreak;
+
+        // GB4: Break after (Control | CR | LF)
+        if (A == GCB::Control || A == GCB::CR || A == GCB::LF)
+            return pair_rule::Break;
+
+        // GB5: Break before (Control | CR | LF)
+        if (B == GCB::Control || B == GCB::CR || B == GCB::LF)
+            return pair_rule::Break;
+
+        // GB6: Do not break Hangul syllable sequences.
+        if (A == GCB::L && (B == GCB::L || B == GCB::V || B == GCB::LV || B == GCB::LVT))
+            return pair_rule::NoBreak;
+
+        // GB7:
+        if ((A == GCB::LV || A == GCB::V) && (B == GCB::V || B == GCB::T))
+            return pair_rule::NoBreak;
+
+        // GB8:
+        if ((A == GCB::LVT || A == GCB::T) && B == GCB::T)
+            return pair_rule::NoBreak;
+
+        // GB9: Do not break before extending characters.
+        if (B == GCB::Extend || B == GCB::ZWJ)
+            return pair_rule::NoBreak;
+
+        // GB9a: Do not break before SpacingMarks
+        if (B == GCB::SpacingMark)
+            return pair_rule::NoBreak;
+
+        // GB9b: or after Prepend characters.
+        if (A == GCB::Prepend)
+            return pair_rule::NoBreak;
+
+        // GB9c (InCB=Linker|Extend × InCB=Consonant) and GB11 (ZWJ × Extended_Pictographic)
+        // can only apply after Extend or ZWJ, as all InCB=Linker|Extend codepoints are one of those.
+        if (A == GCB::Extend || A == GCB::ZWJ)
+            return pair_rule::Conditional;
+
+        // GB12/GB13: Do not break within emoji flag sequences.
+        if (A == GCB::Regional_Indicator && B == GCB::Regional_Indicator)
+            return pair_rule::Conditional;
+
+        // GB999: Otherwise, break everywhere.
+        return pair_rule::Break;
+    }
+
+    constexpr auto PairRules = []() {
+        auto rules = std::array<std::array<pair_rule, GraphemeClusterBreakCount>, GraphemeClusterBreakCount> {};
+        for (size_t a = 0; a < GraphemeClusterBreakCount; ++a)
+            for (size_t b = 0; b < GraphemeClusterBreakCount; ++b)
+                rules[a][b] = decide_pair(static_cast<Grapheme_Cluster_Break>(a), static_cast<Grapheme_Cluster_Break>(b));
+        return rules;
+    }();
+
+} // namespace
+
+void grapheme_process_init(char32_t nextCodepoint,
+                           codepoint_properties const& nextProperties,
+                           grapheme_segmenter_state& state) noexcept
+{
+    auto const Pb = nextProperties;
     auto const B = Pb.grapheme_cluster_break;
 
     state.previousCodepoint = nextCodepoint;
@@ -28,41 +111,34 @@ void grapheme_process_init(char32_t nextCodepoint, grapheme_segmenter_state& sta
     state.extpic_state = Pb.is_extended_pictographic() ? 1 : 0;
 }
 
-bool grapheme_process_breakable(char32_t nextCodepoint, grapheme_segmenter_state& state) noexcept
+bool grapheme_process_breakable(char32_t nextCodepoint,
+                                codepoint_properties const& nextProperties,
+                                grapheme_segmenter_state& state) noexcept
 {
     auto const a = state.previousCodepoint;
-    auto const Pa = state.previousProperties;
-    auto const A = Pa.grapheme_cluster_break;
+    auto const A = state.previousProperties.grapheme_cluster_break;
 
     auto const b = nextCodepoint;
-    auto const Pb = codepoint_properties::get(b);
+    auto const Pb = nextProperties;
     auto const B = Pb.grapheme_cluster_break;
 
     state.previousCodepoint = b;
     state.previousProperties = Pb;
 
-    {
-        // Set state.ri_counter to zero if the next codepoint is not of category Regional_Indicator.
-        //
-        // We move the state.ri_counter out to help GCC optimize
-        // this code to be branchless.
-        // Sadly only GCC succeeds in doing this and Clang fails.
-        auto const ri_counter = state.ri_counter;
-        state.ri_counter = (B == Grapheme_Cluster_Break::Regional_Indicator) ? ri_counter : 0;
-    }
-
-    // GB3: Do not break between a CR and LF. Otherwise, break before and after controls.
-    if (A == Grapheme_Cluster_Break::CR && B == Grapheme_Cluster_Break::LF)
-        return false;
+    // GB12/GB13 state: parity of the number of consecutive Regional_Indicator codepoints up to and including b.
+    auto const prev_ri_counter = state.ri_counter;
+    if (B != Grapheme_Cluster_Break::Regional_Indicator)
+        state.ri_counter = 0;
+    else
+        state.ri_counter = (A == Grapheme_Cluster_Break::Regional_Indicator) ? prev_ri_counter ^ 1 : 1;
 
-    // GB4 (a) + GB5 (b) part 1 (C0 characers) + US-ASCII shortcut
-    // The US-ASCII part is a pure optimization improving performance
-    // in standard Latin text.
+    // US-ASCII shortcut, a pure optimization improving performance in standard Latin text.
+    // GB3 (CR × LF) is the only pair of US-ASCII characters not to break.
     if (a < 128 && b < 128)
     {
         state.incb_state = 0;   // ASCII resets InCB tracking
         state.extpic_state = 0; // ASCII resets ExtPic tracking
-        return true;
+        return !(a == '\r' && b == '\n');
     }
 
     // GB9c: Indic conjunct break state machine update.
@@ -93,41 +169,14 @@ bool grapheme_process_breakable(char32_t nextCodepoint, grapheme_segmenter_state
             state.extpic_state = 0;
     }
 
-    // GB4: Break after (Control | CR | LF)
-    if (A == Grapheme_Cluster_Break::Control || A == Grapheme_Cluster_Break::CR || A == Grapheme_Cluster_Break::LF)
-        return true;
-
-    // GB5: Break before (Control | CR | LF)
-    if (B == Grapheme_Cluster_Break::Control || B == Grapheme_Cluster_Break::CR || B == Grapheme_Cluster_Break::LF)
-        return true;
-
-    // Do not break Hangul syllable sequences.
-    // GB6:
-    if (A == Grapheme_Cluster_Break::L
-        && (B == Grapheme_Cluster_Break::L || B == Grapheme_Cluster_Break::V || B == Grapheme_Cluster_Break::LV
-            || B == Grapheme_Cluster_Break::LVT))
-        return false;
+    auto const rule = PairRules[static_cast<size_t>(A)][static_cast<size_t>(B)];
+    if (rule != pair_rule::Conditional)
+        return rule == pair_rule::Break;
 
-    // GB7:
-    if ((A == Grapheme_Cluster_Break::LV || A == Grapheme_Cluster_Break::V)
-        && (B == Grapheme_Cluster_Break::V || B == Grapheme_Cluster_Break::T))
-        return false;
-
-    // GB8:
-    if ((A == Grapheme_Cluster_Break::LVT || A == Grapheme_Cluster_Break::T) && B == Grapheme_Cluster_Break::T)
-        return false;
-
-    // GB9: Do not break before extending characters.
-    if (B == Grapheme_Cluster_Break::Extend || B == Grapheme_Cluster_Break::ZWJ)
-        return false;
-
-    // GB9a: Do not break before SpacingMarks
-    if (B == Grapheme_Cluster_Break::SpacingMark)
-        return false;
-
-    // GB9b: or after Prepend characters.
-    if (A == Grapheme_Cluster_Break::Prepend)
-        return false;
+    // GB12/GB13: Do not break between regional indicator (RI) symbols
+    // if there is an odd number of RI characters before the break point.
+    if (A == Grapheme_Cluster_Break::Regional_Indicator)
+        return prev_ri_counter == 0;
 
     // GB9c: Do not break within Indic conjunct clusters.
     // Pattern: \p{InCB=Consonant} [\p{InCB=Extend}\p{InCB=Linker}]* \p{InCB=Linker}
@@ -140,16 +189,6 @@ bool grapheme_process_breakable(char32_t nextCodepoint, grapheme_segmenter_state
     if (A == Grapheme_Cluster_Break::ZWJ && Pb.is_extended_pictographic() && prev_extpic_state == 1)
         return false;
 
-    // GB12/GB13: Do not break within emoji flag sequences.
-    // That is, do not break between regional indicator (RI) symbols
-    // if there is an odd number of RI characters before the break point.
-    if (A == Grapheme_Cluster_Break::Regional_Indicator && A == B && state.ri_counter == 1)
-    {
-        state.ri_counter = static_cast<uint8_t>((state.ri_counter + 1) % 2);
-        return false;
-    }
-
-    // GB999: Otherwise, break everywhere.
     return true;
 }
 
@@ -31,7 +31,9 @@ struct grapheme_segmenter_state
     char32_t previousCodepoint = {};
     codepoint_properties previousProperties = codepoint_properties::get(0);
 
-    uint8_t ri_counter = 0; // modulo 2
+    /// GB12/GB13 parity of the number of consecutive Regional_Indicator codepoints
+    /// up to and including the previous codepoint.
+    uint8_t ri_counter = 0;
 
     /// GB9c Indic conjunct break state:
     /// 0 = no conjunct context
@@ -45,13 +47,34 @@ struct grapheme_segmenter_state
     uint8_t extpic_state = 0;
 };
 
-void grapheme_process_init(char32_t nextCodepoint, grapheme_segmenter_state& state) noexcept;
+void grapheme_process_init(char32_t nextCodepoint,
+                           codepoint_properties const& nextProperties,
+                           grapheme_segmenter_state& state) noexcept;
+
+inline void grapheme_process_init(char32_t nextCodepoint, grapheme_segmenter_state& state) noexcept
+{
+    grapheme_process_init(nextCodepoint, codepoint_properties::get(nextCodepoint), state);
+}
 
 /// Tests if codepoint @p a and @p b are breakable, and thus, two different grapheme clusters.
 ///
+/// This overload takes the already looked up properties of @p nextCodepoint,
+/// for callers that need them for more than segmentation (e.g. width measurement).
+///
 /// @retval true both codepoints to not belong to the same grapheme cluster
 /// @retval false both codepoints belong to the same grapheme cluster
-bool grapheme_process_breakable(char32_t nextCodepoint, grapheme_segmenter_state& state) noexcept;
+bool grapheme_process_breakable(char32_t nextCodepoint,
+                                codepoint_properties const& nextProperties,
+                                grapheme_segmenter_state& state) noexcept;
+
+/// Tests if codepoint @p a and @p b are breakable, and thus, two different grapheme clusters.
+///
+/// @retval true both codepoints to not belong to the same grapheme cluster
+/// @retval false both codepoints belong to the same grapheme cluster
+inline bool grapheme_process_breakable(char32_t nextCodepoint, grapheme_segmenter_state& state) noexcept
+{
+    return grapheme_process_breakable(nextCodepoint, codepoint_properties::get(nextCodepoint), state);
+}
 
 /// Implements https://www.unicode.org/reports/tr29/#Grapheme_Cluster_Boundary_Rules
 class grapheme_segmenter
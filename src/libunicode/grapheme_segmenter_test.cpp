@@ -276,6 +276,21 @@ TEST_CASE("grapheme_segmenter.iterator_3: regional flags invalid 2", "[grapheme_
     REQUIRE_FALSE(gs.codepointsAvailable());
 }
 
+TEST_CASE("grapheme_segmenter.iterator_3: regional flags after non-RI", "[grapheme_segmenter]")
+{
+    auto const ri_SD = u32string { U"\U0001F1F8\U0001F1E9" };
+    auto const ri_E = u32string { U"\U0001F1EA" };
+    auto const codepoints = U"x" + ri_SD + ri_E;
+    auto gs = grapheme_segmenter { codepoints };
+
+    REQUIRE(*gs == U"x");
+    ++gs;
+    REQUIRE(*gs == ri_SD);
+    ++gs;
+    REQUIRE(*gs == ri_E);
+    REQUIRE_FALSE(gs.codepointsAvailable());
+}
+
 // ---- GB9c: Indic conjunct break rule tests ----
 
 TEST_CASE("grapheme_segmenter.gb9c_basic_devanagari", "[grapheme_segmenter]")
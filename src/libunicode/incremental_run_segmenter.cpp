@@ -0,0 +1,136 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/incremental_run_segmenter.h>
+#include <libunicode/support.h>
+
+#include <cassert>
+
+namespace unicode
+{
+
+namespace
+{
+    constexpr Script scriptOf(hashed_run const& run) noexcept
+    {
+        return std::get<Script>(run.range.properties);
+    }
+
+    hashed_run makeHashedRun(std::u32string_view text, run_segmenter::range const& range) noexcept
+    {
+        return hashed_run { range, hash_run(text.substr(range.start, range.end - range.start), range.properties) };
+    }
+} // namespace
+
+uint64_t hash_run(std::u32string_view text, run_segmenter::property_tuple const& properties) noexcept
+{
+    auto hasher = codepoint_hasher {};
+    for (auto const codepoint: text)
+        hasher(codepoint);
+    hasher(static_cast<char32_t>(std::get<Script>(properties)));
+    hasher(static_cast<char32_t>(std::get<PresentationStyle>(properties)));
+    return hasher.value();
+}
+
+std::vector<hashed_run> segment_runs(std::u32string_view text)
+{
+    auto runs = std::vector<hashed_run> {};
+    auto segmenter = run_segmenter { text };
+    auto range = run_segmenter::range {};
+    while (segmenter.consume(out(range)))
+        runs.push_back(makeHashedRun(text, range));
+    return runs;
+}
+
+std::pair<size_t, size_t> resegment_runs(std::u32string_view text, text_edit edit, std::vector<hashed_run>& runs)
+{
+    if (runs.empty() || text.empty())
+    {
+        runs = segment_runs(text);
+        return { 0, runs.size() };
+    }
+
+    assert(edit.start + edit.removedCount <= runs.back().range.end);
+    assert(edit.start + edit.insertedCount <= text.size());
+
+    // The run the edit starts in. An edit at the very start of a run may as well extend the run before.
+    auto first = size_t { 0 };
+    while (first + 1 < runs.size() && runs[first + 1].range.start <= edit.start)
+        ++first;
+    if (first > 0 && runs[first].range.start == edit.start)
+        --first;
+
+    // Script resolution depends on the whole script run, so restart where the script changes.
+    // At such a boundary, the segmenters carry no state over from the text before it.
+    while (first > 0 && scriptOf(runs[first - 1]) == scriptOf(runs[first]))
+        --first;
+
+    auto const restart = runs[first].range.start;
+    auto const newEditEnd = edit.start + edit.insertedCount;
+    auto const shift = [&](size_t oldOffset) {
+        return oldOffset + edit.insertedCount - edit.removedCount;
+    };
+
+    auto resegmented = std::vector<hashed_run> {};
+    auto last = first;
+    auto converged = false;
+    auto segmenter = run_segmenter { text.substr(restart) };
+    auto range = run_segmenter::range {};
+    while (segmenter.consume(out(range)))
+    {
+        range.start += restart;
+        range.end += restart;
+
+        if (range.start >= newEditEnd)
+        {
+            // Past the edit, the text is unchanged. Once a run starts at a script boundary in both the
+            // new and the old segmentation, all runs from there on are the same as before.
+            while (last < runs.size() && shift(runs[last].range.start) < range.start)
+                ++last;
+
+            if (last < runs.size() && last > 0 && shift(runs[last].range.start) == range.start
+                && shift(runs[last].range.end) == range.end && runs[last].range.properties == range.properties
+                && scriptOf(runs[last - 1]) != scriptOf(runs[last]))
+            {
+                auto const startsScriptRun = [&]() {
+                    if (!resegmented.empty())
+                        return scriptOf(resegmented.back()) != std::get<Script>(range.properties);
+                    return first == 0 || scriptOf(runs[first - 1]) != std::get<Script>(range.properties);
+                };
+                if (startsScriptRun())
+                {
+                    converged = true;
+                    break;
+                }
+            }
+        }
+
+        resegmented.push_back(makeHashedRun(text, range));
+    }
+
+    if (!converged)
+        last = runs.size();
+
+    for (auto i = last; i < runs.size(); ++i)
+    {
+        runs[i].range.start = shift(runs[i].range.start);
+        runs[i].range.end = shift(runs[i].range.end);
+    }
+
+    runs.erase(runs.begin() + static_cast<std::ptrdiff_t>(first), runs.begin() + static_cast<std::ptrdiff_t>(last));
+    runs.insert(runs.begin() + static_cast<std::ptrdiff_t>(first), resegmented.begin(), resegmented.end());
+
+    return { first, first + resegmented.size() };
+}
+
+} // namespace unicode
@@ -0,0 +1,71 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <libunicode/run_segmenter.h>
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace unicode
+{
+
+/// A run of run_segmenter, together with a hash of its text and properties.
+///
+/// The hash does not depend on where in the line the run is located, nor on the process computing it,
+/// so equal hashes identify runs that shape to the same glyphs, e.g. as key into a glyph run cache.
+struct hashed_run
+{
+    run_segmenter::range range;
+    uint64_t hash;
+
+    constexpr bool operator==(hashed_run const& other) const noexcept
+    {
+        return range == other.range && hash == other.hash;
+    }
+};
+
+/// Describes an edit of a line of text: @c removedCount codepoints at offset @c start were replaced
+/// by @c insertedCount codepoints.
+struct text_edit
+{
+    size_t start;
+    size_t removedCount;
+    size_t insertedCount;
+};
+
+/// Returns the hash of a run with the given @p text and @p properties.
+uint64_t hash_run(std::u32string_view text, run_segmenter::property_tuple const& properties) noexcept;
+
+/// Segments @p text into runs, each carrying its hash.
+std::vector<hashed_run> segment_runs(std::u32string_view text);
+
+/// Updates the runs of a line of text to an edit of that line.
+///
+/// Only the runs around the edit are segmented again. Segmentation restarts at the beginning of the
+/// script run the edit starts in, and stops as soon as it arrives at a script run boundary after the
+/// edit that the previous segmentation had as well; all runs from there on are taken over as they
+/// are, only moved by the length difference of the edit. The result equals segment_runs(text).
+///
+/// @param text  the line of text after the edit.
+/// @param edit  the edit applied to the line.
+/// @param runs  the runs of the line before the edit, as returned by segment_runs() or resegment_runs().
+///              Receives the runs of the line after the edit.
+///
+/// @returns the index range [first, last) of the runs in @p runs that have been segmented again.
+std::pair<size_t, size_t> resegment_runs(std::u32string_view text, text_edit edit, std::vector<hashed_run>& runs);
+
+} // namespace unicode
@@ -74,6 +74,9 @@ struct intrinsics<128, T>
     /// Tests if all bytes in the vector have the high bit clear (all ASCII).
     static inline bool all_ascii(vec_t a) noexcept { return _mm_movemask_epi8(a) == 0; }
 
+    /// Signed byte-wise a > b, returning 0xFF in each matching lane (0x00 otherwise).
+    static inline vec_t cmpgt_epi8(vec_t a, vec_t b) noexcept { return _mm_cmpgt_epi8(a, b); }
+
     /// Zero-extends the lower 4 bytes to 4 x 32-bit integers.
     static inline vec_t cvtepu8_epi32(vec_t a) noexcept { return _mm_cvtepu8_epi32(a); }
 
@@ -131,6 +134,9 @@ struct intrinsics<256, T>
     /// Tests if all bytes in the vector have the high bit clear (all ASCII).
     static inline bool all_ascii(vec_t a) noexcept { return _mm256_movemask_epi8(a) == 0; }
 
+    /// Signed byte-wise a > b, returning 0xFF in each matching lane (0x00 otherwise).
+    static inline vec_t cmpgt_epi8(vec_t a, vec_t b) noexcept { return _mm256_cmpgt_epi8(a, b); }
+
     /// Zero-extends 8 bytes from a 128-bit source to 8 x 32-bit integers in a 256-bit vector.
     static inline vec_t cvtepu8_epi32(__m128i a) noexcept { return _mm256_cvtepu8_epi32(a); }
 
@@ -185,6 +191,9 @@ struct intrinsics<512, T>
     /// Tests if all bytes in the vector have the high bit clear (all ASCII).
     static inline bool all_ascii(vec_t a) noexcept { return _mm512_movepi8_mask(a) == 0; }
 
+    /// Signed byte-wise a > b, returning 0xFF in each matching lane (0x00 otherwise).
+    static inline vec_t cmpgt_epi8(vec_t a, vec_t b) noexcept { return _mm512_movm_epi8(_mm512_cmpgt_epi8_mask(a, b)); }
+
     /// Zero-extends 16 bytes from a 128-bit source to 16 x 32-bit integers in a 512-bit vector.
     static inline vec_t cvtepu8_epi32(__m128i a) noexcept { return _mm512_cvtepu8_epi32(a); }
 
@@ -345,6 +354,12 @@ struct intrinsics<128, T>
     /// Tests if all bytes in the vector have the high bit clear (all ASCII).
     static inline bool all_ascii(vec_t a) noexcept { return movemask_epi8(a) == 0; }
 
+    /// Signed byte-wise a > b, returning 0xFF in each matching lane (0x00 otherwise).
+    static inline vec_t cmpgt_epi8(vec_t a, vec_t b) noexcept
+    {
+        return vreinterpretq_s64_u8(vcgtq_s8(vreinterpretq_s8_s64(a), vreinterpretq_s8_s64(b)));
+    }
+
     /// Stores 128-bit vector to unaligned memory as 32-bit integers.
     static inline void store(void* p, vec_t a) noexcept { vst1q_s32(reinterpret_cast<int32_t*>(p), vreinterpretq_s32_s64(a)); }
 
@@ -0,0 +1,140 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/cluster_walker.h>
+#include <libunicode/line_index.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace unicode
+{
+
+namespace
+{
+    /// Tests whether a grapheme cluster boundary lies before byte @p offset, whatever precedes it.
+    ///
+    /// US-ASCII characters never extend or join one another, except CR LF.
+    bool isCertainBoundary(std::string_view text, size_t offset) noexcept
+    {
+        auto const previous = static_cast<uint8_t>(text[offset - 1]);
+        auto const next = static_cast<uint8_t>(text[offset]);
+        return previous < 0x80 && next < 0x80 && !(previous == '\r' && next == '\n');
+    }
+} // namespace
+
+line_index::line_index(std::string_view utf8Text, size_t interval): _text { utf8Text }
+{
+    auto const starts = std::vector<size_t> { 0 };
+    auto const chunks = std::vector<chunk> { indexChunk(utf8Text, interval) };
+    join(starts, chunks);
+}
+
+std::vector<size_t> line_index::chunkStarts(std::string_view utf8Text, size_t chunkCount)
+{
+    auto starts = std::vector<size_t> { 0 };
+    for (size_t i = 1; i < chunkCount; ++i)
+    {
+        // Look for a place to start at within the i-th chunk only, so the search is bounded.
+        auto const searchEnd = utf8Text.size() * (i + 1) / chunkCount;
+        for (auto offset = std::max(utf8Text.size() * i / chunkCount, starts.back() + 1); offset < searchEnd; ++offset)
+        {
+            if (isCertainBoundary(utf8Text, offset))
+            {
+                starts.push_back(offset);
+                break;
+            }
+        }
+    }
+    return starts;
+}
+
+line_index::chunk line_index::indexChunk(std::string_view utf8Text, size_t interval)
+{
+    assert(interval != 0);
+
+    auto result = chunk {};
+    auto nextOffset = size_t { 0 };
+
+    detail::walk_clusters(
+        utf8Text,
+        [&](size_t start, size_t /*end*/, size_t column, size_t width) noexcept {
+            if (start >= nextOffset)
+            {
+                result.checkpoints.push_back(checkpoint { start, column, result.clusterCount });
+                nextOffset = start + interval;
+            }
+            ++result.clusterCount;
+            result.width = column + width;
+            return false;
+        },
+        [&](size_t start, size_t count, size_t column) noexcept {
+            // Each character of the run is a cluster of its own, one column wide.
+            for (auto offset = std::max(start, nextOffset); offset < start + count; offset += interval)
+            {
+                result.checkpoints.push_back(
+                    checkpoint { offset, column + (offset - start), result.clusterCount + (offset - start) });
+                nextOffset = offset + interval;
+            }
+            result.clusterCount += count;
+            result.width = column + count;
+            return false;
+        });
+
+    return result;
+}
+
+void line_index::join(std::vector<size_t> const& starts, std::vector<chunk> const& chunks)
+{
+    _checkpoints.clear();
+    _width = 0;
+    _clusterCount = 0;
+
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        for (auto const& relative: chunks[i].checkpoints)
+            _checkpoints.push_back(checkpoint { starts[i] + relative.offset,
+                                                _width + relative.column,
+                                                _clusterCount + relative.clusterCount });
+        _width += chunks[i].width;
+        _clusterCount += chunks[i].clusterCount;
+    }
+
+    if (_checkpoints.empty())
+        _checkpoints.push_back(checkpoint { 0, 0, 0 });
+}
+
+column_offset line_index::find_column_offset(size_t column) const noexcept
+{
+    // The last checkpoint at or before the column. No cluster before it can reach the column.
+    auto const i = std::prev(std::upper_bound(
+        _checkpoints.begin(), _checkpoints.end(), column, [](size_t value, checkpoint const& entry) {
+            return value < entry.column;
+        }));
+
+    auto const found = unicode::find_column_offset(_text.substr(i->offset), column - i->column);
+    return column_offset { i->offset + found.offset, i->column + found.column };
+}
+
+size_t line_index::column_of_offset(size_t offset) const noexcept
+{
+    auto const i = std::prev(std::upper_bound(
+        _checkpoints.begin(), _checkpoints.end(), offset, [](size_t value, checkpoint const& entry) {
+            return value < entry.offset;
+        }));
+
+    return i->column + unicode::column_of_offset(_text.substr(i->offset), offset - i->offset);
+}
+
+} // namespace unicode
@@ -0,0 +1,101 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <libunicode/width.h>
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace unicode
+{
+
+/// Sparse index of the grapheme clusters and columns of a very long UTF-8 encoded line of text.
+///
+/// Built in a single pass, it records a checkpoint at the first grapheme cluster boundary after
+/// every @c interval bytes. As neither the grapheme segmenter nor the width measurement carry any
+/// state across a cluster boundary, a query resumes scanning at the nearest checkpoint, found by
+/// binary search, so that it costs O(log n) plus a scan of about @c interval bytes.
+///
+/// The index refers to the text it was built from, which therefore has to outlive it.
+class line_index
+{
+  public:
+    /// A grapheme cluster boundary of the line.
+    struct checkpoint
+    {
+        size_t offset;       ///< Byte offset of the cluster starting here.
+        size_t column;       ///< Column of the cluster starting here.
+        size_t clusterCount; ///< Number of clusters before this one.
+    };
+
+    static constexpr size_t default_interval = 4096;
+
+    /// Indexes @p utf8Text, recording a checkpoint about every @p interval bytes.
+    explicit line_index(std::string_view utf8Text, size_t interval = default_interval);
+
+    /// Indexes @p utf8Text in up to @p chunkCount chunks, which are scanned in parallel.
+    ///
+    /// @p parallelFor is called as parallelFor(n, task), and must call task(i) for every i in [0, n),
+    /// in any order and on any threads, and return once all of them have completed.
+    ///
+    /// Chunks can only begin where a cluster boundary is certain without knowing the text before,
+    /// that is, between two US-ASCII characters. Text without any such place is indexed as one chunk.
+    template <typename ParallelFor>
+    line_index(std::string_view utf8Text, size_t interval, size_t chunkCount, ParallelFor&& parallelFor):
+        _text { utf8Text }
+    {
+        auto const starts = chunkStarts(utf8Text, chunkCount);
+        auto chunks = std::vector<chunk>(starts.size());
+        parallelFor(starts.size(), [&](size_t i) {
+            auto const end = i + 1 < starts.size() ? starts[i + 1] : utf8Text.size();
+            chunks[i] = indexChunk(utf8Text.substr(starts[i], end - starts[i]), interval);
+        });
+        join(starts, chunks);
+    }
+
+    /// Finds the grapheme cluster that occupies @p column, as find_column_offset() does.
+    [[nodiscard]] column_offset find_column_offset(size_t column) const noexcept;
+
+    /// Returns the column of the grapheme cluster containing byte @p offset, as column_of_offset() does.
+    [[nodiscard]] size_t column_of_offset(size_t offset) const noexcept;
+
+    /// Display width of the whole line.
+    [[nodiscard]] size_t width() const noexcept { return _width; }
+
+    /// Number of grapheme clusters of the whole line.
+    [[nodiscard]] size_t cluster_count() const noexcept { return _clusterCount; }
+
+    [[nodiscard]] std::vector<checkpoint> const& checkpoints() const noexcept { return _checkpoints; }
+
+  private:
+    struct chunk
+    {
+        std::vector<checkpoint> checkpoints; // relative to the chunk's start
+        size_t width = 0;
+        size_t clusterCount = 0;
+    };
+
+    static std::vector<size_t> chunkStarts(std::string_view utf8Text, size_t chunkCount);
+    static chunk indexChunk(std::string_view utf8Text, size_t interval);
+    void join(std::vector<size_t> const& starts, std::vector<chunk> const& chunks);
+
+    std::string_view _text;
+    std::vector<checkpoint> _checkpoints;
+    size_t _width = 0;
+    size_t _clusterCount = 0;
+};
+
+} // namespace unicode
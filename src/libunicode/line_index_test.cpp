@@ -0,0 +1,114 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/line_index.h>
+#include <libunicode/test_random_text.h>
+#include <libunicode/width.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace unicode;
+
+namespace
+{
+// Runs the tasks back to front, so that no chunk can rely on the ones before it being done.
+auto const backwardsFor = [](size_t count, auto const& task) {
+    for (size_t i = count; i > 0; --i)
+        task(i - 1);
+};
+
+void checkAgainstUnindexed(line_index const& index, std::string_view text)
+{
+    auto const width = static_cast<size_t>(grapheme_cluster_width(text));
+    CHECK(index.width() == width);
+    CHECK(index.cluster_count() == detail::measure_utf8_text(text, false).clusterCount);
+
+    for (size_t column = 0; column <= width + 1; ++column)
+    {
+        INFO("column: " << column);
+        auto const expected = find_column_offset(text, column);
+        auto const actual = index.find_column_offset(column);
+        CHECK(actual.offset == expected.offset);
+        CHECK(actual.column == expected.column);
+    }
+
+    for (size_t offset = 0; offset <= text.size() + 1; ++offset)
+    {
+        INFO("offset: " << offset);
+        CHECK(index.column_of_offset(offset) == column_of_offset(text, offset));
+    }
+}
+} // namespace
+
+TEST_CASE("line_index.empty", "[line_index]")
+{
+    auto const index = line_index { ""sv };
+    CHECK(index.width() == 0);
+    CHECK(index.cluster_count() == 0);
+    CHECK(index.checkpoints().size() == 1);
+    CHECK(index.find_column_offset(5).offset == 0);
+    CHECK(index.column_of_offset(5) == 0);
+}
+
+TEST_CASE("line_index.checkpoints", "[line_index]")
+{
+    auto const text = std::string(100, 'x');
+    auto const index = line_index { text, 16 };
+    REQUIRE(index.checkpoints().size() == 7);
+    for (size_t i = 0; i < index.checkpoints().size(); ++i)
+    {
+        CHECK(index.checkpoints()[i].offset == i * 16);
+        CHECK(index.checkpoints()[i].column == i * 16);
+        CHECK(index.checkpoints()[i].clusterCount == i * 16);
+    }
+    CHECK(index.find_column_offset(70).offset == 70);
+    CHECK(index.column_of_offset(99) == 99);
+}
+
+TEST_CASE("line_index.matches_unindexed", "[line_index]")
+{
+    // Wide, zero-width and multi-codepoint clusters, ASCII runs, invalid UTF-8 and CR LF.
+    auto const pieces = std::array<std::string_view, 14> {
+        "abcdef"sv,
+        " "sv,
+        "\u4E2D"sv,
+        "\u0301"sv,
+        "\u0600"sv,
+        "\u0915\u094D\u0928"sv,
+        "\U0001F468\u200D\U0001F469\u200D\U0001F467"sv,
+        "\u2764\uFE0F"sv,
+        "\U0001F1E9\U0001F1EA"sv,
+        "\U0001F1E9"sv,
+        "\x80"sv,
+        "\xE4\xB8"sv,
+        "\r\n"sv,
+        "\u200D"sv,
+    };
+
+    auto randomText = test::random_text_generator { pieces };
+    for (int round = 0; round < 200; ++round)
+    {
+        auto const text = randomText(39);
+        INFO("text: " << text);
+
+        auto const interval = 1 + randomText.below(12);
+        checkAgainstUnindexed(line_index { text, interval }, text);
+        checkAgainstUnindexed(line_index { text, interval, 4, backwardsFor }, text);
+    }
+}
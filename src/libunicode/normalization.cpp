@@ -11,13 +11,21 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <libunicode/case_mapping.h>
 #include <libunicode/case_normalization_data.h>
+#include <libunicode/codepoint_reader.h>
+#include <libunicode/codepoint_properties.h>
 #include <libunicode/convert.h>
 #include <libunicode/normalization.h>
+#include <libunicode/support.h>
 
 #include <algorithm>
+#include <array>
 #include <iterator>
+#include <optional>
 #include <span>
+#include <type_traits>
+#include <utility>
 
 namespace unicode
 {
@@ -88,6 +96,118 @@ namespace
         return Decomposition_Type::None;
     }
 
+    template <size_t N>
+    [[nodiscard]] constexpr char32_t first_codepoint(std::array<char32_t, N> const& table) noexcept
+    {
+        if constexpr (N == 0)
+            return 0x110000;
+        else
+            return table.front();
+    }
+
+    [[nodiscard]] constexpr char32_t first_non_starter() noexcept
+    {
+        for (auto const& [codepoint, ccc]: detail::ccc_table)
+            if (ccc != 0)
+                return codepoint;
+        return 0x110000;
+    }
+
+    /// Returns the smallest codepoint that has a non-zero CCC or a quick-check value other
+    /// than Yes for the given form. Every codepoint below it is a starter that passes the
+    /// quick check unconditionally (e.g. U+0300 for NFC).
+    [[nodiscard]] constexpr char32_t quick_check_threshold(Normalization_Form form) noexcept
+    {
+        switch (form)
+        {
+            case Normalization_Form::NFC:
+                return std::min({ first_non_starter(),
+                                  first_codepoint(detail::nfc_qc_no_table),
+                                  first_codepoint(detail::nfc_qc_maybe_table) });
+            case Normalization_Form::NFD:
+                return std::min(first_non_starter(), first_codepoint(detail::nfd_qc_no_table));
+            case Normalization_Form::NFKC:
+                return std::min({ first_non_starter(),
+                                  first_codepoint(detail::nfkc_qc_no_table),
+                                  first_codepoint(detail::nfkc_qc_maybe_table) });
+            case Normalization_Form::NFKD:
+                return std::min(first_non_starter(), first_codepoint(detail::nfkd_qc_no_table));
+        }
+        return 0;
+    }
+
+    /// Returns the exclusive upper bound for UTF-8 bytes that can only be part of codepoints
+    /// below @p threshold, i.e. the UTF-8 lead byte of @p threshold (rounded down).
+    [[nodiscard]] constexpr uint8_t utf8_byte_limit(char32_t threshold) noexcept
+    {
+        if (threshold < 0x80)
+            return static_cast<uint8_t>(threshold);
+        if (threshold < 0x800)
+            return static_cast<uint8_t>(0xC0 | (threshold >> 6));
+        if (threshold < 0x10000)
+            return static_cast<uint8_t>(0xE0 | (threshold >> 12));
+        return static_cast<uint8_t>(0xF0 | std::min<char32_t>(threshold >> 18, 0x07));
+    }
+
+    constexpr std::array<char32_t, 4> quick_check_thresholds {
+        quick_check_threshold(Normalization_Form::NFC),
+        quick_check_threshold(Normalization_Form::NFD),
+        quick_check_threshold(Normalization_Form::NFKC),
+        quick_check_threshold(Normalization_Form::NFKD),
+    };
+
+    /// Feeds a single codepoint into a running quick check.
+    /// Returns false as soon as the text is definitely not normalized.
+    [[nodiscard]] bool quick_check_step(char32_t cp,
+                                        Normalization_Form form,
+                                        uint8_t& lastCcc,
+                                        Quick_Check_Result& result) noexcept
+    {
+        if (cp < quick_check_thresholds[static_cast<size_t>(form)])
+        {
+            lastCcc = 0;
+            return true;
+        }
+
+        uint8_t const ccc = canonical_combining_class(cp);
+
+        // Check canonical ordering
+        if (ccc != 0 && lastCcc > ccc)
+            return false;
+
+        lastCcc = ccc;
+
+        // Check quick check property
+        switch (form)
+        {
+            case Normalization_Form::NFC: {
+                auto const qc = nfc_quick_check(cp);
+                if (qc == NFC_Quick_Check::No)
+                    return false;
+                if (qc == NFC_Quick_Check::Maybe)
+                    result = Quick_Check_Result::Maybe;
+                break;
+            }
+            case Normalization_Form::NFD: return nfd_quick_check(cp);
+            case Normalization_Form::NFKC: {
+                auto const qc = nfkc_quick_check(cp);
+                if (qc == NFKC_Quick_Check::No)
+                    return false;
+                if (qc == NFKC_Quick_Check::Maybe)
+                    result = Quick_Check_Result::Maybe;
+                break;
+            }
+            case Normalization_Form::NFKD: return nfkd_quick_check(cp);
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] constexpr bool is_utf8_continuation(char ch) noexcept
+    {
+        return (static_cast<uint8_t>(ch) & 0xC0) == 0x80;
+    }
+
     // Try to compose two codepoints
     [[nodiscard]] char32_t try_compose(char32_t first, char32_t second) noexcept
     {
@@ -131,13 +251,16 @@ namespace
         return 0; // No composition found
     }
 
-    void decompose_recursive(char32_t cp, std::u32string& output, bool compatibility)
+    /// Invokes @p output for each codepoint of the full decomposition of @p cp.
+    template <typename Output>
+    void for_each_decomposed(char32_t cp, bool compatibility, Output&& output)
     {
         if (is_hangul_syllable(cp))
         {
             char32_t jamos[3];
             auto const count = hangul_decompose(cp, jamos);
-            output.append(jamos, jamos + count);
+            for (size_t i = 0; i < count; ++i)
+                output(jamos[i]);
             return;
         }
 
@@ -148,12 +271,56 @@ namespace
 
         if (decomp.empty())
         {
-            output.push_back(cp);
+            output(cp);
             return;
         }
 
         for (char32_t c: decomp)
-            decompose_recursive(c, output, compatibility);
+            for_each_decomposed(c, compatibility, output);
+    }
+
+    void decompose_recursive(char32_t cp, std::u32string& output, bool compatibility)
+    {
+        for_each_decomposed(cp, compatibility, [&](char32_t c) { output.push_back(c); });
+    }
+
+    /// Writes the full decomposition of @p cp into @p output, truncating if it does not fit.
+    /// Returns its full length, so that the caller can tell whether it was truncated.
+    size_t decompose_into(char32_t cp, std::span<char32_t> output, bool compatibility) noexcept
+    {
+        size_t length = 0;
+        char32_t first = 0;
+        for_each_decomposed(cp, compatibility, [&](char32_t c) {
+            if (length == 0)
+                first = c;
+            if (length < output.size())
+                output[length] = c;
+            ++length;
+        });
+
+        // A codepoint that decomposes to itself has no decomposition.
+        if (length == 1 && first == cp)
+            return 0;
+
+        return length;
+    }
+
+    /// Returns the canonical combining class of the first codepoint of the full decomposition of @p cp.
+    [[nodiscard]] uint8_t leading_ccc(char32_t cp, bool compatibility) noexcept
+    {
+        while (true)
+        {
+            if (is_hangul_syllable(cp))
+                return 0;
+
+            auto decomp = find_decomposition(detail::canonical_decomposition_table, cp);
+            if (decomp.empty() && compatibility)
+                decomp = find_decomposition(detail::compatibility_decomposition_table, cp);
+            if (decomp.empty())
+                return canonical_combining_class(cp);
+
+            cp = decomp.front();
+        }
     }
 
     // Canonical ordering of combining marks
@@ -202,7 +369,9 @@ namespace
         if (i >= decomposed.size())
             return result;
 
-        char32_t starter = decomposed[i++];
+        // The starter stays in place; marks that do not compose with it follow it.
+        size_t starter = result.size();
+        result.push_back(decomposed[i++]);
         uint8_t last_ccc = 0;
 
         while (i < decomposed.size())
@@ -214,19 +383,19 @@ namespace
             char32_t composed = 0;
             if (last_ccc < ccc || last_ccc == 0)
             {
-                composed = try_compose(starter, cp);
+                composed = try_compose(result[starter], cp);
             }
 
             if (composed != 0 && !is_composition_exclusion(composed))
             {
                 // Composition succeeded
-                starter = composed;
+                result[starter] = composed;
             }
             else if (ccc == 0)
             {
                 // New starter
-                result.push_back(starter);
-                starter = cp;
+                starter = result.size();
+                result.push_back(cp);
                 last_ccc = 0;
             }
             else
@@ -239,10 +408,330 @@ namespace
             ++i;
         }
 
-        result.push_back(starter);
         return result;
     }
 
+    // ========================================================================
+    // Lazy decomposition
+    // ========================================================================
+
+    /// Yields the canonically ordered full decomposition (NFD or NFKD) of a codepoint
+    /// stream one segment at a time, a segment being a starter followed by its non-starters.
+    ///
+    /// Segments are held in a fixed inline buffer. If a segment does not fit (which
+    /// does not happen for Stream-Safe Text, UAX#15 Section 13), next() stops early and
+    /// overflowed() returns true; callers then fall back to full normalization.
+    template <typename Reader>
+    class lazy_decomposition
+    {
+      public:
+        lazy_decomposition(Reader reader, bool compatibility) noexcept:
+            _reader(std::move(reader)), _compatibility(compatibility)
+        {
+        }
+
+        /// Returns the next decomposed codepoint or std::nullopt at the end of the text.
+        [[nodiscard]] std::optional<char32_t> next() noexcept
+        {
+            if (_position == _ready && !fill())
+                return std::nullopt;
+            return _codepoints[_position++];
+        }
+
+        [[nodiscard]] bool overflowed() const noexcept { return _overflowed || _reader.overflowed(); }
+
+      private:
+        static constexpr size_t Capacity = 64;
+
+        bool fill() noexcept
+        {
+            // Drop the segment that has been consumed already.
+            std::copy(_codepoints.begin() + _ready, _codepoints.begin() + _size, _codepoints.begin());
+            std::copy(_cccs.begin() + _ready, _cccs.begin() + _size, _cccs.begin());
+            _size -= _ready;
+            _position = 0;
+            _ready = 0;
+
+            // Decompose until a starter after the first codepoint closes the segment.
+            size_t scanned = 1;
+            while (_ready == 0)
+            {
+                for (; scanned < _size; ++scanned)
+                {
+                    if (_cccs[scanned] == 0)
+                    {
+                        _ready = scanned;
+                        break;
+                    }
+                }
+                if (_ready != 0)
+                    break;
+
+                auto const cp = _reader.next();
+                if (!cp.has_value())
+                {
+                    _ready = _size;
+                    break;
+                }
+
+                for_each_decomposed(*cp, _compatibility, [this](char32_t c) {
+                    if (_size == Capacity)
+                    {
+                        _overflowed = true;
+                        return;
+                    }
+                    _codepoints[_size] = c;
+                    _cccs[_size] = canonical_combining_class(c);
+                    ++_size;
+                });
+                if (_overflowed)
+                    return false;
+            }
+
+            // Canonical ordering of the non-starters (stable insertion sort by CCC).
+            for (size_t i = 1; i < _ready; ++i)
+            {
+                for (size_t j = i; j > 0 && _cccs[j] != 0 && _cccs[j - 1] > _cccs[j]; --j)
+                {
+                    std::swap(_codepoints[j - 1], _codepoints[j]);
+                    std::swap(_cccs[j - 1], _cccs[j]);
+                }
+            }
+
+            return _ready != 0;
+        }
+
+        Reader _reader;
+        bool _compatibility;
+        bool _overflowed = false;
+        size_t _size = 0;     ///< Number of decomposed codepoints in the buffer
+        size_t _ready = 0;    ///< Number of leading codepoints that form complete, ordered segments
+        size_t _position = 0; ///< Read position within the ready codepoints
+        std::array<char32_t, Capacity> _codepoints {};
+        std::array<uint8_t, Capacity> _cccs {};
+    };
+
+    /// Yields the canonical composition (NFC or NFKC) of a decomposed, canonically ordered
+    /// codepoint stream, one run (a starter and the marks that did not compose with it)
+    /// at a time. Like lazy_decomposition, overly long runs set overflowed().
+    template <typename Source>
+    class lazy_composition
+    {
+      public:
+        explicit lazy_composition(Source source) noexcept: _source(std::move(source)) {}
+
+        /// Returns the next composed codepoint or std::nullopt at the end of the text.
+        [[nodiscard]] std::optional<char32_t> next() noexcept
+        {
+            if (_position == _ready && !fill())
+                return std::nullopt;
+            return _codepoints[_position++];
+        }
+
+        [[nodiscard]] bool overflowed() const noexcept { return _overflowed || _source.overflowed(); }
+
+      private:
+        static constexpr size_t Capacity = 64;
+
+        bool fill() noexcept
+        {
+            // Keep the open run, its starter may still compose with what follows.
+            std::copy(_codepoints.begin() + _ready, _codepoints.begin() + _size, _codepoints.begin());
+            _size -= _ready;
+            _position = 0;
+            _ready = 0;
+
+            while (_ready == 0)
+            {
+                auto const cp = _source.next();
+                if (!cp.has_value())
+                {
+                    _ready = _size;
+                    break;
+                }
+
+                auto const ccc = canonical_combining_class(*cp);
+                if (_hasStarter && (_lastCcc < ccc || _lastCcc == 0))
+                {
+                    auto const composed = try_compose(_codepoints[0], *cp);
+                    if (composed != 0 && !is_composition_exclusion(composed))
+                    {
+                        _codepoints[0] = composed;
+                        continue;
+                    }
+                }
+
+                if (ccc == 0)
+                {
+                    // A starter that does not compose closes the current run.
+                    _ready = _size;
+                    _hasStarter = true;
+                    _lastCcc = 0;
+                }
+                else
+                    _lastCcc = ccc;
+
+                if (_size == Capacity)
+                {
+                    _overflowed = true;
+                    return false;
+                }
+                _codepoints[_size++] = *cp;
+            }
+
+            return _ready != 0;
+        }
+
+        Source _source;
+        bool _overflowed = false;
+        bool _hasStarter = false; ///< Whether the open run begins with a starter
+        uint8_t _lastCcc = 0;     ///< CCC of the last codepoint that did not compose
+        size_t _size = 0;
+        size_t _ready = 0;
+        size_t _position = 0;
+        std::array<char32_t, Capacity> _codepoints {};
+    };
+
+    template <typename T>
+    using codepoint_reader_for = std::conditional_t<std::is_same_v<T, char>, detail::utf8_codepoint_reader, detail::u32_codepoint_reader>;
+
+    /// Hashes a lazily produced codepoint stream.
+    /// Returns std::nullopt if the stream overflowed its inline buffers.
+    template <typename Source>
+    [[nodiscard]] std::optional<uint64_t> hash_stream(Source source) noexcept
+    {
+        auto hasher = codepoint_hasher {};
+        while (auto const cp = source.next())
+            hasher(*cp);
+        if (source.overflowed())
+            return std::nullopt;
+        return hasher.value();
+    }
+
+    [[nodiscard]] uint64_t hash_codepoints(std::u32string_view text) noexcept
+    {
+        auto hasher = codepoint_hasher {};
+        for (char32_t const cp: text)
+            hasher(cp);
+        return hasher.value();
+    }
+
+    template <typename T>
+    [[nodiscard]] std::u32string to_u32(std::basic_string_view<T> text)
+    {
+        if constexpr (std::is_same_v<T, char>)
+            return convert_to<char32_t>(text);
+        else
+            return std::u32string(text);
+    }
+
+    template <typename T>
+    [[nodiscard]] uint64_t hash_normalized(std::basic_string_view<T> text, Normalization_Form form)
+    {
+        auto const compatibility = form == Normalization_Form::NFKC || form == Normalization_Form::NFKD;
+        auto decomposed = lazy_decomposition(codepoint_reader_for<T> { text }, compatibility);
+
+        auto const hash = form == Normalization_Form::NFD || form == Normalization_Form::NFKD
+                              ? hash_stream(std::move(decomposed))
+                              : hash_stream(lazy_composition(std::move(decomposed)));
+        if (hash.has_value())
+            return *hash;
+
+        return hash_codepoints(normalize(std::u32string_view(to_u32(text)), form));
+    }
+
+    /// Hashes the compatibility caseless form NFKC(toCasefold(NFKD(toCasefold(NFD(X))))),
+    /// see Unicode Standard, Chapter 3.13, D146.
+    template <typename T>
+    [[nodiscard]] uint64_t hash_compatibility_caseless(std::basic_string_view<T> text)
+    {
+        using Reader = codepoint_reader_for<T>;
+        auto const lazyNfd = lazy_decomposition(Reader { text }, false);
+        auto const lazyNfkd = lazy_decomposition(detail::casefold_reader(lazyNfd), true);
+        auto const hash = hash_stream(lazy_composition(lazy_decomposition(detail::casefold_reader(lazyNfkd), true)));
+        if (hash.has_value())
+            return *hash;
+
+        auto const nfd = normalize(std::u32string_view(to_u32(text)), Normalization_Form::NFD);
+        auto const nfkd = normalize(std::u32string_view(casefold(nfd)), Normalization_Form::NFKD);
+        return hash_codepoints(normalize(std::u32string_view(casefold(nfkd)), Normalization_Form::NFKC));
+    }
+
+    /// Compares the decompositions of two texts lazily, stopping at the first difference.
+    /// Returns std::nullopt if a segment exceeded the inline buffer.
+    template <typename Reader>
+    [[nodiscard]] std::optional<bool> lazy_decompositions_equal(Reader a, Reader b, bool compatibility) noexcept
+    {
+        auto decomposedA = lazy_decomposition<Reader>(std::move(a), compatibility);
+        auto decomposedB = lazy_decomposition<Reader>(std::move(b), compatibility);
+
+        while (true)
+        {
+            auto const cpA = decomposedA.next();
+            auto const cpB = decomposedB.next();
+            if (decomposedA.overflowed() || decomposedB.overflowed())
+                return std::nullopt;
+            if (cpA != cpB)
+                return false;
+            if (!cpA.has_value())
+                return true;
+        }
+    }
+
+    /// Returns the length of the common prefix of @p a and @p b that ends at a normalization
+    /// boundary in both texts, so that only the remainders need to be compared.
+    [[nodiscard]] size_t common_normalized_prefix(std::u32string_view a, std::u32string_view b, Normalization_Form form)
+    {
+        auto const mismatch = std::mismatch(a.begin(), a.end(), b.begin(), b.end());
+        auto i = static_cast<size_t>(std::distance(a.begin(), mismatch.first));
+
+        auto const is_boundary_at = [form](std::u32string_view text, size_t position) {
+            return position == text.size() || is_normalization_boundary(text[position], form);
+        };
+
+        while (i > 0 && !(is_boundary_at(a, i) && is_boundary_at(b, i)))
+            --i;
+
+        return i;
+    }
+
+    /// Returns the length of the common prefix of @p a and @p b (in bytes) that ends at a
+    /// normalization boundary in both texts.
+    [[nodiscard]] size_t common_normalized_prefix(std::string_view a, std::string_view b, Normalization_Form form)
+    {
+        auto const mismatch = std::mismatch(a.begin(), a.end(), b.begin(), b.end());
+        auto i = static_cast<size_t>(std::distance(a.begin(), mismatch.first));
+
+        auto const is_boundary_at = [form](std::string_view text, size_t position) {
+            return position == text.size()
+                   || (!is_utf8_continuation(text[position])
+                       && is_normalization_boundary(decode_utf8(text.substr(position)).codepoint, form));
+        };
+
+        while (i > 0 && !(is_boundary_at(a, i) && is_boundary_at(b, i)))
+            --i;
+
+        return i;
+    }
+
+    template <typename T>
+    [[nodiscard]] bool is_equivalent(std::basic_string_view<T> a, std::basic_string_view<T> b, Normalization_Form form)
+    {
+        if (a == b)
+            return true;
+
+        auto const prefix = common_normalized_prefix(a, b, form);
+        a.remove_prefix(prefix);
+        b.remove_prefix(prefix);
+
+        using Reader = codepoint_reader_for<T>;
+        auto const compatibility = form == Normalization_Form::NFKD;
+        if (auto const equal = lazy_decompositions_equal(Reader { a }, Reader { b }, compatibility); equal.has_value())
+            return *equal;
+
+        return normalize(a, form) == normalize(b, form);
+    }
+
 } // anonymous namespace
 
 // ============================================================================
@@ -279,6 +768,16 @@ std::vector<char32_t> compatibility_decomposition(char32_t codepoint)
     return result;
 }
 
+size_t canonical_decomposition(char32_t codepoint, std::span<char32_t> output) noexcept
+{
+    return decompose_into(codepoint, output, false);
+}
+
+size_t compatibility_decomposition(char32_t codepoint, std::span<char32_t> output) noexcept
+{
+    return decompose_into(codepoint, output, true);
+}
+
 Decomposition_Type decomposition_type(char32_t codepoint) noexcept
 {
     if (is_hangul_syllable(codepoint))
@@ -373,58 +872,49 @@ std::string normalize(std::string_view text, Normalization_Form form)
 
 Quick_Check_Result quick_check(std::u32string_view text, Normalization_Form form)
 {
-    Quick_Check_Result result = Quick_Check_Result::Yes;
-    uint8_t last_ccc = 0;
+    auto result = Quick_Check_Result::Yes;
+    uint8_t lastCcc = 0;
 
     for (char32_t cp: text)
-    {
-        uint8_t ccc = canonical_combining_class(cp);
-
-        // Check canonical ordering
-        if (ccc != 0 && last_ccc > ccc)
+        if (!quick_check_step(cp, form, lastCcc, result))
             return Quick_Check_Result::No;
 
-        last_ccc = ccc;
+    return result;
+}
 
-        // Check quick check property
-        switch (form)
+Quick_Check_Result quick_check(std::string_view text, Normalization_Form form)
+{
+    // Bytes below this limit only occur in codepoints that are starters with quick-check
+    // value Yes, so whole blocks of them are accepted without decoding.
+    auto const byteLimit = utf8_byte_limit(quick_check_thresholds[static_cast<size_t>(form)]);
+
+    auto result = Quick_Check_Result::Yes;
+    uint8_t lastCcc = 0;
+    decoder<char> decode {};
+    size_t i = 0;
+
+    while (i < text.size())
+    {
+        if (!decode.expectedLength)
         {
-            case Normalization_Form::NFC: {
-                auto qc = nfc_quick_check(cp);
-                if (qc == NFC_Quick_Check::No)
-                    return Quick_Check_Result::No;
-                if (qc == NFC_Quick_Check::Maybe)
-                    result = Quick_Check_Result::Maybe;
-                break;
-            }
-            case Normalization_Form::NFD:
-                if (!nfd_quick_check(cp))
-                    return Quick_Check_Result::No;
-                break;
-            case Normalization_Form::NFKC: {
-                auto qc = nfkc_quick_check(cp);
-                if (qc == NFKC_Quick_Check::No)
-                    return Quick_Check_Result::No;
-                if (qc == NFKC_Quick_Check::Maybe)
-                    result = Quick_Check_Result::Maybe;
-                break;
+            auto const accepted = detail::count_leading_bytes_below(text.data() + i, text.size() - i, byteLimit);
+            if (accepted)
+            {
+                lastCcc = 0;
+                i += accepted;
+                continue;
             }
-            case Normalization_Form::NFKD:
-                if (!nfkd_quick_check(cp))
-                    return Quick_Check_Result::No;
-                break;
         }
+
+        // Per-codepoint check around a potential offender.
+        auto const cp = decode(static_cast<uint8_t>(text[i++]));
+        if (cp.has_value() && !quick_check_step(cp.value(), form, lastCcc, result))
+            return Quick_Check_Result::No;
     }
 
     return result;
 }
 
-Quick_Check_Result quick_check(std::string_view text, Normalization_Form form)
-{
-    auto const u32text = convert_to<char32_t>(text);
-    return quick_check(std::u32string_view(u32text), form);
-}
-
 bool is_normalized(std::u32string_view text, Normalization_Form form)
 {
     auto qc = quick_check(text, form);
@@ -440,8 +930,93 @@ bool is_normalized(std::u32string_view text, Normalization_Form form)
 
 bool is_normalized(std::string_view text, Normalization_Form form)
 {
+    auto const qc = quick_check(text, form);
+    if (qc != Quick_Check_Result::Maybe)
+        return qc == Quick_Check_Result::Yes;
+
     auto const u32text = convert_to<char32_t>(text);
-    return is_normalized(std::u32string_view(u32text), form);
+    return normalize(std::u32string_view(u32text), form) == u32text;
+}
+
+bool is_normalization_boundary(char32_t codepoint, Normalization_Form form) noexcept
+{
+    // Non-starters are never boundaries
+    if (canonical_combining_class(codepoint) != 0)
+        return false;
+
+    // For decomposition forms, a starter is a safe boundary unless its
+    // decomposition begins with a non-starter (e.g. U+0F73)
+    if (form == Normalization_Form::NFD || form == Normalization_Form::NFKD)
+        return codepoint < quick_check_thresholds[static_cast<size_t>(form)]
+               || leading_ccc(codepoint, form == Normalization_Form::NFKD) == 0;
+
+    // For composition forms, a starter is safe only if its quick-check value
+    // is Yes (it cannot compose with the preceding segment)
+    if (form == Normalization_Form::NFC)
+        return nfc_quick_check(codepoint) == NFC_Quick_Check::Yes;
+
+    return nfkc_quick_check(codepoint) == NFKC_Quick_Check::Yes;
+}
+
+// ============================================================================
+// Incremental normalization
+// ============================================================================
+
+normalization_patch<char32_t> renormalize(std::u32string_view text,
+                                          size_t editOffset,
+                                          size_t editLength,
+                                          Normalization_Form form)
+{
+    editOffset = std::min(editOffset, text.size());
+    auto const editEnd = std::min(editOffset + editLength, text.size());
+
+    // Walk back to the nearest boundary at or before the edit.
+    auto windowStart = editOffset;
+    while (windowStart > 0 && (windowStart == text.size() || !is_normalization_boundary(text[windowStart], form)))
+        --windowStart;
+
+    // Walk forward to the nearest boundary at or after the end of the edit.
+    auto windowEnd = editEnd;
+    while (windowEnd < text.size() && !is_normalization_boundary(text[windowEnd], form))
+        ++windowEnd;
+
+    auto const window = text.substr(windowStart, windowEnd - windowStart);
+    return { .offset = windowStart, .length = window.size(), .replacement = normalize(window, form) };
+}
+
+normalization_patch<char> renormalize(std::string_view text, size_t editOffset, size_t editLength, Normalization_Form form)
+{
+    editOffset = std::min(editOffset, text.size());
+    auto editEnd = std::min(editOffset + editLength, text.size());
+
+    // Align the edit range to codepoint boundaries.
+    while (editOffset > 0 && editOffset < text.size() && is_utf8_continuation(text[editOffset]))
+        --editOffset;
+    while (editEnd < text.size() && is_utf8_continuation(text[editEnd]))
+        ++editEnd;
+
+    // Walk back to the nearest boundary at or before the edit.
+    auto windowStart = editOffset;
+    while (windowStart > 0
+           && (windowStart == text.size() || !is_normalization_boundary(decode_utf8(text.substr(windowStart)).codepoint, form)))
+    {
+        --windowStart;
+        while (windowStart > 0 && is_utf8_continuation(text[windowStart]))
+            --windowStart;
+    }
+
+    // Walk forward to the nearest boundary at or after the end of the edit.
+    auto windowEnd = editEnd;
+    while (windowEnd < text.size())
+    {
+        auto const [codepoint, length] = decode_utf8(text.substr(windowEnd));
+        if (is_normalization_boundary(codepoint, form))
+            break;
+        windowEnd += length;
+    }
+
+    auto const window = text.substr(windowStart, windowEnd - windowStart);
+    return { .offset = windowStart, .length = window.size(), .replacement = normalize(window, form) };
 }
 
 // ============================================================================
@@ -450,22 +1025,173 @@ bool is_normalized(std::string_view text, Normalization_Form form)
 
 bool is_canonically_equivalent(std::u32string_view a, std::u32string_view b)
 {
-    return to_nfd(a) == to_nfd(b);
+    return is_equivalent(a, b, Normalization_Form::NFD);
 }
 
 bool is_canonically_equivalent(std::string_view a, std::string_view b)
 {
-    return to_nfd(a) == to_nfd(b);
+    return is_equivalent(a, b, Normalization_Form::NFD);
 }
 
 bool is_compatibility_equivalent(std::u32string_view a, std::u32string_view b)
 {
-    return to_nfkd(a) == to_nfkd(b);
+    return is_equivalent(a, b, Normalization_Form::NFKD);
 }
 
 bool is_compatibility_equivalent(std::string_view a, std::string_view b)
 {
-    return to_nfkd(a) == to_nfkd(b);
+    return is_equivalent(a, b, Normalization_Form::NFKD);
+}
+
+// ============================================================================
+// Normalization-aware hashing
+// ============================================================================
+
+uint64_t hash_nfc(std::u32string_view text)
+{
+    return hash_normalized(text, Normalization_Form::NFC);
+}
+
+uint64_t hash_nfc(std::string_view text)
+{
+    return hash_normalized(text, Normalization_Form::NFC);
+}
+
+uint64_t hash_nfd(std::u32string_view text)
+{
+    return hash_normalized(text, Normalization_Form::NFD);
+}
+
+uint64_t hash_nfd(std::string_view text)
+{
+    return hash_normalized(text, Normalization_Form::NFD);
+}
+
+uint64_t hash_casefold_nfkc(std::u32string_view text)
+{
+    return hash_compatibility_caseless(text);
+}
+
+uint64_t hash_casefold_nfkc(std::string_view text)
+{
+    return hash_compatibility_caseless(text);
+}
+
+// ============================================================================
+// Search folding
+// ============================================================================
+
+search_folder::search_folder(std::u32string_view text, Search_Fold_Form form) noexcept:
+    _u32text { text }, _isUtf8 { false }, _compatibility { form == Search_Fold_Form::Compatibility }
+{
+}
+
+search_folder::search_folder(std::string_view text, Search_Fold_Form form) noexcept:
+    _utf8text { text }, _isUtf8 { true }, _compatibility { form == Search_Fold_Form::Compatibility }
+{
+}
+
+bool search_folder::next(char32_t& codepoint) noexcept
+{
+    if (_foldedPosition == _foldedLength && !fill())
+        return false;
+    codepoint = _folded[_foldedPosition++];
+    return true;
+}
+
+namespace
+{
+    [[nodiscard]] bool is_nonspacing_mark(char32_t codepoint) noexcept
+    {
+        return codepoint_properties::get(codepoint).general_category == General_Category::Nonspacing_Mark;
+    }
+} // namespace
+
+void search_folder::append(char32_t codepoint) noexcept
+{
+    // Not reachable for any assigned codepoint: at most 18 decomposed codepoints, each folding to at most 3.
+    if (_foldedLength < Capacity)
+        _folded[_foldedLength++] = codepoint;
+}
+
+bool search_folder::fill() noexcept
+{
+    _foldedLength = 0;
+    _foldedPosition = 0;
+
+    // Loop as a source codepoint may consist of nonspacing marks only, and fold to nothing.
+    while (_foldedLength == 0)
+    {
+        auto const size = _isUtf8 ? _utf8text.size() : _u32text.size();
+        if (_position == size)
+            return false;
+
+        _sourceOffset = _position;
+
+        char32_t codepoint {};
+        if (_isUtf8)
+        {
+            auto const [decoded, length] = decode_utf8(_utf8text.substr(_position));
+            codepoint = decoded;
+            _position += length;
+        }
+        else
+            codepoint = _u32text[_position++];
+
+        // ASCII neither decomposes nor has marks, and folds to lowercase.
+        if (codepoint < 0x80)
+        {
+            _folded[_foldedLength++] = simple_casefold(codepoint);
+            break;
+        }
+
+        for_each_decomposed(codepoint, _compatibility, [&](char32_t decomposed) {
+            if (is_nonspacing_mark(decomposed))
+                return;
+
+            auto const mapping = full_casefold(decomposed);
+            if (mapping.is_identity())
+            {
+                append(decomposed);
+                return;
+            }
+
+            // Case folding may yield decomposable codepoints or marks again (e.g. U+0130 -> i U+0307).
+            for (auto const folded: mapping.view())
+                for_each_decomposed(folded, _compatibility, [&](char32_t c) {
+                    if (!is_nonspacing_mark(c))
+                        append(c);
+                });
+        });
+    }
+
+    return true;
+}
+
+std::u32string search_fold(std::u32string_view text, Search_Fold_Form form)
+{
+    auto result = std::u32string {};
+    result.reserve(text.size());
+
+    auto folder = search_folder(text, form);
+    char32_t codepoint {};
+    while (folder.next(codepoint))
+        result.push_back(codepoint);
+
+    return result;
+}
+
+std::string search_fold(std::string_view text, Search_Fold_Form form)
+{
+    auto result = std::string {};
+    result.reserve(text.size());
+
+    auto folder = search_folder(text, form);
+    char32_t codepoint {};
+    while (folder.next(codepoint))
+        encoder<char> {}(codepoint, std::back_inserter(result));
+
+    return result;
 }
 
 // ============================================================================
@@ -543,20 +1269,7 @@ normalizer::normalizer(Normalization_Form form) noexcept: _form(form)
 
 bool normalizer::is_boundary(char32_t codepoint) const noexcept
 {
-    // Non-starters are never boundaries
-    if (canonical_combining_class(codepoint) != 0)
-        return false;
-
-    // For decomposition forms, every starter is a safe boundary
-    if (_form == Normalization_Form::NFD || _form == Normalization_Form::NFKD)
-        return true;
-
-    // For composition forms, a starter is safe only if its quick-check value
-    // is Yes (it cannot compose with the preceding segment)
-    if (_form == Normalization_Form::NFC)
-        return nfc_quick_check(codepoint) == NFC_Quick_Check::Yes;
-
-    return nfkc_quick_check(codepoint) == NFKC_Quick_Check::Yes;
+    return is_normalization_boundary(codepoint, _form);
 }
 
 std::u32string_view normalizer::emit_pending()
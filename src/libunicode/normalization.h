@@ -16,7 +16,9 @@
 #include <libunicode/ucd_enums.h>
 #include <libunicode/utf8.h>
 
+#include <array>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -57,6 +59,24 @@ enum class Quick_Check_Result : uint8_t
 /// Includes canonical decompositions.
 [[nodiscard]] std::vector<char32_t> compatibility_decomposition(char32_t codepoint);
 
+/// Writes the full (recursively applied) canonical decomposition of a codepoint into @p output,
+/// without allocating.
+///
+/// @param output Buffer for the result. A buffer of MaxCanonicalDecompositionLength codepoints
+///               (see ucd_enums.h) is always sufficient.
+/// @return Length of the full decomposition, or 0 if the codepoint has no decomposition.
+///         If that exceeds the size of @p output, only the leading part of it has been written.
+[[nodiscard]] size_t canonical_decomposition(char32_t codepoint, std::span<char32_t> output) noexcept;
+
+/// Writes the full (recursively applied) compatibility decomposition of a codepoint into @p output,
+/// without allocating. Includes canonical decompositions.
+///
+/// @param output Buffer for the result. A buffer of MaxCompatibilityDecompositionLength codepoints
+///               (see ucd_enums.h) is always sufficient.
+/// @return Length of the full decomposition, or 0 if the codepoint has no decomposition.
+///         If that exceeds the size of @p output, only the leading part of it has been written.
+[[nodiscard]] size_t compatibility_decomposition(char32_t codepoint, std::span<char32_t> output) noexcept;
+
 /// Returns the decomposition type for a codepoint.
 [[nodiscard]] Decomposition_Type decomposition_type(char32_t codepoint) noexcept;
 
@@ -194,6 +214,54 @@ enum class Quick_Check_Result : uint8_t
     return is_normalized(text, Normalization_Form::NFKD);
 }
 
+/// Returns true if a normalization boundary precedes @p codepoint in the given form,
+/// i.e. the text before and from @p codepoint on can be normalized independently
+/// (UAX#15 Section 9).
+[[nodiscard]] bool is_normalization_boundary(char32_t codepoint, Normalization_Form form) noexcept;
+
+// ============================================================================
+// Incremental normalization
+// ============================================================================
+
+/// Replacement for a range of an edited buffer, as computed by renormalize().
+template <typename T>
+struct normalization_patch
+{
+    size_t offset = 0;               ///< Start of the range to replace, in code units.
+    size_t length = 0;               ///< Length of the range to replace, in code units.
+    std::basic_string<T> replacement; ///< Normalized text to put in place of the range.
+};
+
+/// Re-normalizes only the part of an edited buffer that is affected by an edit.
+///
+/// The buffer must have been normalized in @p form before the edit was applied.
+/// The window to re-normalize is widened from the edit range to the enclosing
+/// normalization boundaries (see is_normalization_boundary()), so the cost only
+/// depends on the size of the edit and its surrounding combining sequences, not
+/// on the size of the buffer.
+///
+/// @code
+///     text.insert(cursor, typed);
+///     auto const patch = renormalize(std::u32string_view(text), cursor, typed.size(), form);
+///     text.replace(patch.offset, patch.length, patch.replacement);
+/// @endcode
+///
+/// @param text       The buffer with the edit already applied.
+/// @param editOffset Start of the inserted or modified range (or the deletion point).
+/// @param editLength Length of the inserted or modified range (0 for deletions).
+/// @param form       The normalization form the buffer is kept in.
+[[nodiscard]] normalization_patch<char32_t> renormalize(std::u32string_view text,
+                                                        size_t editOffset,
+                                                        size_t editLength,
+                                                        Normalization_Form form);
+
+/// Re-normalizes only the part of an edited UTF-8 buffer that is affected by an edit.
+/// Offsets and lengths are in bytes.
+[[nodiscard]] normalization_patch<char> renormalize(std::string_view text,
+                                                    size_t editOffset,
+                                                    size_t editLength,
+                                                    Normalization_Form form);
+
 // ============================================================================
 // Canonical equivalence
 // ============================================================================
@@ -210,6 +278,102 @@ enum class Quick_Check_Result : uint8_t
 /// Returns true if two UTF-8 strings are compatibility equivalent.
 [[nodiscard]] bool is_compatibility_equivalent(std::string_view a, std::string_view b);
 
+// ============================================================================
+// Normalization-aware hashing
+// ============================================================================
+//
+// These functions hash the codepoints of a normalized form of the input (using
+// codepoint_hasher) without materializing it, so unnormalized strings can be used
+// as hash keys directly. The hash of a text only depends on its codepoints, so
+// UTF-8 and UTF-32 inputs with the same content hash equal.
+
+/// Returns the hash of the NFC form of @p text.
+/// Canonically equivalent strings (see is_canonically_equivalent()) have equal hashes.
+[[nodiscard]] uint64_t hash_nfc(std::u32string_view text);
+
+/// Returns the hash of the NFC form of the UTF-8 string @p text.
+[[nodiscard]] uint64_t hash_nfc(std::string_view text);
+
+/// Returns the hash of the NFD form of @p text.
+/// Canonically equivalent strings (see is_canonically_equivalent()) have equal hashes.
+[[nodiscard]] uint64_t hash_nfd(std::u32string_view text);
+
+/// Returns the hash of the NFD form of the UTF-8 string @p text.
+[[nodiscard]] uint64_t hash_nfd(std::string_view text);
+
+/// Returns the hash of the compatibility caseless form of @p text,
+/// NFKC(toCasefold(NFKD(toCasefold(NFD(text))))) (Unicode Standard, Chapter 3.13, D146).
+/// Strings that match caselessly under compatibility equivalence have equal hashes.
+[[nodiscard]] uint64_t hash_casefold_nfkc(std::u32string_view text);
+
+/// Returns the hash of the compatibility caseless form of the UTF-8 string @p text.
+/// Invalid UTF-8 sequences are skipped, as convert_to<char32_t>() does.
+[[nodiscard]] uint64_t hash_casefold_nfkc(std::string_view text);
+
+// ============================================================================
+// Search folding
+// ============================================================================
+//
+// Search folding maps text to a key for accent- and case-insensitive matching,
+// so that "resume" matches "Résumé", in a single pass: each codepoint is fully
+// decomposed, nonspacing marks (General_Category=Mn) are dropped, and the rest
+// is case-folded. The result is a matching key, neither normalized nor meant
+// for display (e.g. Hangul syllables come out as conjoining jamo).
+
+/// Decomposition applied by search folding.
+enum class Search_Fold_Form : uint8_t
+{
+    Canonical,    ///< Canonical decomposition only, e.g. "é" matches "e".
+    Compatibility ///< Compatibility decomposition, additionally e.g. "ﬁ" matches "fi" and "²" matches "2".
+};
+
+/// Lazily yields the search folding of a UTF-32 or UTF-8 text, one codepoint at a time.
+///
+/// The viewed text must outlive the folder.
+///
+/// @code
+///     auto folder = search_folder(haystack);
+///     char32_t codepoint {};
+///     while (folder.next(codepoint))
+///         feed(codepoint, folder.source_offset());
+/// @endcode
+class search_folder
+{
+  public:
+    explicit search_folder(std::u32string_view text, Search_Fold_Form form = Search_Fold_Form::Canonical) noexcept;
+    explicit search_folder(std::string_view text, Search_Fold_Form form = Search_Fold_Form::Canonical) noexcept;
+
+    /// Retrieves the next folded codepoint.
+    /// @retval false the text is exhausted.
+    [[nodiscard]] bool next(char32_t& codepoint) noexcept;
+
+    /// Returns the offset (in code units of the text) of the source codepoint
+    /// that the most recently retrieved codepoint was folded from.
+    [[nodiscard]] size_t source_offset() const noexcept { return _sourceOffset; }
+
+  private:
+    [[nodiscard]] bool fill() noexcept;
+    void append(char32_t codepoint) noexcept;
+
+    static constexpr size_t Capacity = 64;
+
+    std::u32string_view _u32text;
+    std::string_view _utf8text;
+    bool _isUtf8;
+    bool _compatibility;
+    size_t _position = 0;
+    size_t _sourceOffset = 0;
+    std::array<char32_t, Capacity> _folded {};
+    uint8_t _foldedLength = 0;
+    uint8_t _foldedPosition = 0;
+};
+
+/// Returns the search folding of @p text.
+[[nodiscard]] std::u32string search_fold(std::u32string_view text, Search_Fold_Form form = Search_Fold_Form::Canonical);
+
+/// Returns the search folding of the UTF-8 string @p text.
+[[nodiscard]] std::string search_fold(std::string_view text, Search_Fold_Form form = Search_Fold_Form::Canonical);
+
 // ============================================================================
 // Hangul algorithmic decomposition/composition
 // ============================================================================
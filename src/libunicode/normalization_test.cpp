@@ -11,11 +11,18 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <libunicode/convert.h>
 #include <libunicode/normalization.h>
+#include <libunicode/support.h>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
+#include <string>
+#include <vector>
+
 using namespace unicode;
+using namespace std::string_literals;
 using namespace std::string_view_literals;
 
 TEST_CASE("normalization.canonical_combining_class", "[normalization]")
@@ -89,6 +96,39 @@ TEST_CASE("normalization.canonical_decomposition", "[normalization]")
     CHECK(decomp.empty());
 }
 
+TEST_CASE("normalization.decomposition_into_buffer", "[normalization]")
+{
+    auto buffer = std::array<char32_t, MaxCompatibilityDecompositionLength> {};
+
+    // Fully expanded: U+1E69 -> U+1E63 U+0307 -> s U+0323 U+0307
+    auto length = canonical_decomposition(U'\u1E69', buffer);
+    CHECK(std::u32string_view(buffer.data(), length) == U"s\u0323\u0307");
+
+    length = canonical_decomposition(U'\uAC01', buffer);
+    CHECK(std::u32string_view(buffer.data(), length) == U"\u1100\u1161\u11A8");
+
+    CHECK(canonical_decomposition('A', buffer) == 0);
+    CHECK(canonical_decomposition(U'\uFB01', buffer) == 0);
+
+    length = compatibility_decomposition(U'\uFB01', buffer);
+    CHECK(std::u32string_view(buffer.data(), length) == U"fi");
+
+    // Singleton decomposition (OHM SIGN -> GREEK CAPITAL LETTER OMEGA)
+    length = canonical_decomposition(U'\u2126', buffer);
+    CHECK(std::u32string_view(buffer.data(), length) == U"\u03A9");
+
+    // A short buffer receives the leading part, and the full length tells that it was truncated.
+    auto small = std::array<char32_t, 2> {};
+    CHECK(canonical_decomposition(U'\u1E69', small) == 3);
+    CHECK(std::u32string_view(small.data(), small.size()) == U"s\u0323");
+    CHECK(canonical_decomposition(U'\u1E69', std::span<char32_t> {}) == 3);
+    CHECK(canonical_decomposition('A', std::span<char32_t> {}) == 0);
+
+    // The longest decompositions fill the documented maximum lengths exactly.
+    CHECK(canonical_decomposition(U'\u1F82', buffer) == MaxCanonicalDecompositionLength);
+    CHECK(compatibility_decomposition(U'\uFDFA', buffer) == MaxCompatibilityDecompositionLength);
+}
+
 TEST_CASE("normalization.to_nfd", "[normalization]")
 {
     // é -> e + combining acute
@@ -178,6 +218,84 @@ TEST_CASE("normalization.is_canonically_equivalent_utf8", "[normalization]")
     CHECK_FALSE(is_canonically_equivalent("hello"sv, "world"sv));
 }
 
+TEST_CASE("normalization.is_canonically_equivalent_lazy", "[normalization]")
+{
+    // Mark reordering across a shared prefix
+    CHECK(is_canonically_equivalent(U"prefix a\u0327\u0301 suffix", U"prefix a\u0301\u0327 suffix"));
+    CHECK(is_canonically_equivalent("prefix \u00E1\u0327 suffix"sv, "prefix a\u0327\u0301 suffix"sv));
+    CHECK_FALSE(is_canonically_equivalent(U"prefix a\u0301\u0300", U"prefix a\u0300\u0301"));
+    CHECK_FALSE(is_canonically_equivalent("e\u0301"sv, "e"sv));
+    CHECK_FALSE(is_canonically_equivalent("e"sv, "e\u0301"sv));
+
+    // Hangul syllable vs. conjoining jamo
+    CHECK(is_canonically_equivalent(U"\uAC01", U"\u1100\u1161\u11A8"));
+    CHECK(is_canonically_equivalent("x\uAC01"sv, "x\u1100\u1161\u11A8"sv));
+
+    // Starter whose decomposition begins with non-starters (U+0F73 -> U+0F71 U+0F72)
+    CHECK(is_canonically_equivalent(U"\u0F40\u0F73", U"\u0F40\u0F71\u0F72"));
+
+    // Compatibility equivalence is not canonical equivalence
+    CHECK_FALSE(is_canonically_equivalent(U"\uFB01", U"fi"));
+    CHECK(is_compatibility_equivalent("\uFB01x"sv, "fix"sv));
+
+    // Combining sequences longer than the inline segment buffer
+    auto const longA = U"a"s + std::u32string(100, U'\u0301') + U"\u0327";
+    auto const longB = U"a\u0327"s + std::u32string(100, U'\u0301');
+    CHECK(is_canonically_equivalent(longA, longB));
+    CHECK_FALSE(is_canonically_equivalent(longA, longB + U"\u0301"));
+}
+
+TEST_CASE("normalization.compose_blocked_mark", "[normalization]")
+{
+    // The cedilla does not compose with 'a' but does not block the acute accent either;
+    // it must stay after the composed starter.
+    CHECK(to_nfc(U"a\u0327\u0301") == U"\u00E1\u0327");
+    CHECK(to_nfc(U"a\u0301\u0327") == U"\u00E1\u0327");
+}
+
+TEST_CASE("normalization.hash", "[normalization]")
+{
+    auto const hash_of = [](std::u32string_view text) {
+        auto hasher = codepoint_hasher {};
+        for (auto const cp: text)
+            hasher(cp);
+        return hasher.value();
+    };
+
+    auto const samples = std::array {
+        U"hello"sv, U"e\u0301"sv, U"\u00E9"sv, U"a\u0301\u0327"sv, U"\u1100\u1161\u11A8x"sv, U"\u0F40\u0F73"sv, U"\uFB01"sv, U""sv,
+    };
+    for (auto const text: samples)
+    {
+        auto const utf8 = convert_to<char>(text);
+        CHECK(hash_nfc(text) == hash_of(to_nfc(text)));
+        CHECK(hash_nfd(text) == hash_of(to_nfd(text)));
+        CHECK(hash_nfc(std::string_view(utf8)) == hash_nfc(text));
+        CHECK(hash_nfd(std::string_view(utf8)) == hash_nfd(text));
+        CHECK(hash_casefold_nfkc(std::string_view(utf8)) == hash_casefold_nfkc(text));
+    }
+
+    // Canonically equivalent strings hash equal
+    CHECK(hash_nfc(U"caf\u00E9") == hash_nfc(U"cafe\u0301"));
+    CHECK(hash_nfd("caf\u00E9"sv) == hash_nfd("cafe\u0301"sv));
+    CHECK(hash_nfc(U"\uAC01") == hash_nfc(U"\u1100\u1161\u11A8"));
+    CHECK(hash_nfc(U"hello") != hash_nfc(U"world"));
+    CHECK(hash_nfc(U"\uFB01") != hash_nfc(U"fi"));
+
+    // Compatibility caseless matching
+    CHECK(hash_casefold_nfkc(U"\uFB01") == hash_casefold_nfkc(U"FI"));
+    CHECK(hash_casefold_nfkc("Stra\u00DFe"sv) == hash_casefold_nfkc("STRASSE"sv));
+    CHECK(hash_casefold_nfkc(U"\u00C9") == hash_casefold_nfkc(U"e\u0301"));
+    CHECK(hash_casefold_nfkc(U"\uFF21") == hash_casefold_nfkc(U"a"));
+    CHECK(hash_casefold_nfkc(U"a") != hash_casefold_nfkc(U"b"));
+    CHECK(hash_casefold_nfkc("a\x80" "B"sv) == hash_casefold_nfkc("ab"sv)); // invalid UTF-8 is skipped
+
+    // Combining sequences longer than the inline buffers
+    auto const longText = U"a"s + std::u32string(100, U'\u0301') + U"\u0327";
+    CHECK(hash_nfc(longText) == hash_of(to_nfc(longText)));
+    CHECK(hash_nfd(longText) == hash_of(to_nfd(longText)));
+}
+
 TEST_CASE("normalization.canonical_ordering", "[normalization]")
 {
     // Multiple combining marks should be reordered by CCC
@@ -341,6 +459,62 @@ TEST_CASE("normalization.quick_check_string", "[normalization]")
     CHECK(quick_check(U"\uFB01", Normalization_Form::NFKD) == Quick_Check_Result::No);
 }
 
+TEST_CASE("normalization.quick_check_utf8", "[normalization]")
+{
+    auto constexpr Forms = std::array {
+        Normalization_Form::NFC, Normalization_Form::NFD, Normalization_Form::NFKC, Normalization_Form::NFKD
+    };
+
+    // Long runs of Latin-1, CJK and Hangul text with a potential offender placed at
+    // various offsets around the SIMD block boundaries must agree with the UTF-32 check.
+    auto const offenders = std::array { ""sv, "\u0301"sv, "\u00E9"sv, "\u00A0"sv, "\uFB01"sv, "\u0301\u0327"sv, "\uAC00"sv };
+    auto const fillers = std::array { "a"sv, "\u00FC"sv, "\u4E2D"sv, "\U0001F600"sv };
+
+    for (auto const filler: fillers)
+    {
+        for (auto const offender: offenders)
+        {
+            for (auto const position: std::array<size_t, 11> { 0, 1, 15, 16, 17, 31, 32, 63, 64, 65, 100 })
+            {
+                auto text = std::string {};
+                for (size_t i = 0; i < position; ++i)
+                    text += filler;
+                text += offender;
+                for (size_t i = 0; i < 70; ++i)
+                    text += filler;
+
+                auto const u32text = convert_to<char32_t>(std::string_view(text));
+                for (auto const form: Forms)
+                {
+                    INFO("filler: " << filler << ", offender: " << offender << ", position: " << position
+                                    << ", form: " << static_cast<int>(form));
+                    CHECK(quick_check(std::string_view(text), form) == quick_check(std::u32string_view(u32text), form));
+                    CHECK(is_normalized(std::string_view(text), form) == is_normalized(std::u32string_view(u32text), form));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("normalization.quick_check_utf8_latin", "[normalization]")
+{
+    auto const latin = std::string(200, 'x') + "gr\u00FC\u00DFe";
+    CHECK(quick_check(std::string_view(latin), Normalization_Form::NFC) == Quick_Check_Result::Yes);
+    CHECK(quick_check(std::string_view(latin), Normalization_Form::NFD) == Quick_Check_Result::No);
+    CHECK(is_nfc(std::string_view(latin)));
+    CHECK_FALSE(is_nfd(std::string_view(latin)));
+
+    // A combining mark after a long ASCII run makes NFC quick check return Maybe.
+    auto const decomposed = std::string(200, 'x') + "e\u0301";
+    CHECK(quick_check(std::string_view(decomposed), Normalization_Form::NFC) == Quick_Check_Result::Maybe);
+    CHECK_FALSE(is_nfc(std::string_view(decomposed)));
+    CHECK(is_nfd(std::string_view(decomposed)));
+
+    // Out-of-order combining marks are rejected right away.
+    auto const misordered = std::string(200, 'x') + "a\u0301\u0327";
+    CHECK(quick_check(std::string_view(misordered), Normalization_Form::NFD) == Quick_Check_Result::No);
+}
+
 // ============================================================================
 // Decomposition type for compatibility types
 // ============================================================================
@@ -538,6 +712,100 @@ TEST_CASE("normalization_stream.utf8_reset", "[normalization]")
     CHECK(result.empty());
 }
 
+// ============================================================================
+// Incremental normalization
+// ============================================================================
+
+namespace
+{
+template <typename T>
+std::basic_string<T> apply_edit(std::basic_string<T> text,
+                                size_t offset,
+                                size_t length,
+                                std::basic_string_view<T> insertion,
+                                Normalization_Form form)
+{
+    text.replace(offset, length, insertion);
+    auto const patch = renormalize(std::basic_string_view<T>(text), offset, insertion.size(), form);
+    text.replace(patch.offset, patch.length, patch.replacement);
+    return text;
+}
+} // namespace
+
+TEST_CASE("normalization_incremental.boundary", "[normalization]")
+{
+    CHECK(is_normalization_boundary('a', Normalization_Form::NFC));
+    CHECK_FALSE(is_normalization_boundary(U'\u0301', Normalization_Form::NFC));
+    CHECK_FALSE(is_normalization_boundary(U'\u1161', Normalization_Form::NFC)); // Hangul V composes with L
+    CHECK(is_normalization_boundary(U'\u1161', Normalization_Form::NFD));
+}
+
+TEST_CASE("normalization_incremental.window", "[normalization]")
+{
+    // Appending a combining mark re-normalizes only the last combining sequence.
+    auto const text = U"hello world e\u0301"s;
+    auto const patch = renormalize(std::u32string_view(text), text.size() - 1, 1, Normalization_Form::NFC);
+    CHECK(patch.offset == text.size() - 2);
+    CHECK(patch.length == 2);
+    CHECK(patch.replacement == U"\u00E9");
+
+    // An edit surrounded by boundaries stays within the edit range.
+    auto const plain = U"abcdef"s;
+    auto const plainPatch = renormalize(std::u32string_view(plain), 2, 1, Normalization_Form::NFC);
+    CHECK(plainPatch.offset == 2);
+    CHECK(plainPatch.length == 1);
+    CHECK(plainPatch.replacement == U"c");
+}
+
+TEST_CASE("normalization_incremental.matches_full_normalization", "[normalization]")
+{
+    struct Edit
+    {
+        std::u32string text;
+        size_t offset;
+        size_t length;
+        std::u32string insertion;
+    };
+
+    auto const edits = std::array {
+        Edit { U"cafe", 4, 0, U"\u0301" },                // combining mark appended
+        Edit { U"caf\u00E9 au lait", 4, 0, U"\u0327" },   // mark inserted after precomposed letter
+        Edit { U"ax\u0301", 1, 1, U"" },                  // deletion joins base and mark
+        Edit { U"\u1100 \u1161", 1, 1, U"" },             // deletion joins Hangul L and V
+        Edit { U"\uAC00", 1, 0, U"\u11A8" },              // Hangul LV + T
+        Edit { U"a\u0301b", 2, 0, U"\u0327" },            // mark reordering within a sequence
+        Edit { U"\u00E9\u00E9\u00E9", 0, 1, U"e\u0301" }, // replacement at the front
+    };
+
+    auto constexpr Forms = std::array {
+        Normalization_Form::NFC, Normalization_Form::NFD, Normalization_Form::NFKC, Normalization_Form::NFKD
+    };
+
+    for (auto const form: Forms)
+    {
+        for (auto const& edit: edits)
+        {
+            auto const before = normalize(std::u32string_view(edit.text), form);
+            auto const offset = std::min(edit.offset, before.size());
+            auto const length = std::min(edit.length, before.size() - offset);
+
+            auto expected = before;
+            expected.replace(offset, length, edit.insertion);
+            expected = normalize(std::u32string_view(expected), form);
+
+            INFO("form: " << static_cast<int>(form) << ", offset: " << offset);
+            CHECK(apply_edit<char32_t>(before, offset, length, edit.insertion, form) == expected);
+
+            auto const before8 = convert_to<char>(std::u32string_view(before));
+            auto const offset8 = convert_to<char>(std::u32string_view(before).substr(0, offset)).size();
+            auto const length8 = convert_to<char>(std::u32string_view(before).substr(offset, length)).size();
+            auto const insertion8 = convert_to<char>(std::u32string_view(edit.insertion));
+            CHECK(apply_edit<char>(before8, offset8, length8, std::string_view(insertion8), form)
+                  == convert_to<char>(std::u32string_view(expected)));
+        }
+    }
+}
+
 // ============================================================================
 // Conformance test vectors (representative subset from NormalizationTest.txt)
 // ============================================================================
@@ -584,3 +852,37 @@ TEST_CASE("normalization.conformance_subset", "[normalization]")
         CHECK(to_nfkd(tc.source) == tc.nfkd);
     }
 }
+
+TEST_CASE("normalization.search_fold", "[normalization]")
+{
+    CHECK(search_fold(U"R\u00E9sum\u00E9"sv) == U"resume");
+    CHECK(search_fold(U"Re\u0301sume\u0301"sv) == U"resume");
+    CHECK(search_fold("R\u00C9SUM\u00C9"sv) == "resume");
+    CHECK(search_fold("Stra\u00DFe"sv) == "strasse");
+    CHECK(search_fold("\u0130stanbul"sv) == "istanbul"); // I WITH DOT ABOVE folds to i + U+0307
+    CHECK(search_fold("\u1F88"sv) == "\u03B1");          // GREEK CAPITAL ALPHA WITH PSILI AND PROSGEGRAMMENI
+    CHECK(search_fold("\u0301\u0308"sv).empty());
+    CHECK(search_fold("\uAC00"sv) == "\u1100\u1161");
+
+    // Compatibility mappings only apply in compatibility form.
+    CHECK(search_fold("x\u00B2 \uFF21"sv) == "x\u00B2 \uFF41");
+    CHECK(search_fold("x\u00B2 \uFF21"sv, Search_Fold_Form::Compatibility) == "x2 a");
+    CHECK(search_fold(U"\uFF21\u0301"sv, Search_Fold_Form::Compatibility) == U"a");
+}
+
+TEST_CASE("normalization.search_folder", "[normalization]")
+{
+    // Yields the folded codepoints along with the offsets of their source codepoints.
+    auto const text = "Ce\u0301\u00DF\u0301x"sv;
+    auto folder = search_folder(text);
+    auto folded = std::u32string {};
+    auto offsets = std::vector<size_t> {};
+    char32_t codepoint {};
+    while (folder.next(codepoint))
+    {
+        folded.push_back(codepoint);
+        offsets.push_back(folder.source_offset());
+    }
+    CHECK(folded == U"cessx");
+    CHECK(offsets == std::vector<size_t> { 0, 1, 4, 4, 8 });
+}
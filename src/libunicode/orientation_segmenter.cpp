@@ -0,0 +1,76 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/codepoint_properties.h>
+#include <libunicode/orientation_segmenter.h>
+
+namespace unicode
+{
+
+namespace
+{
+    /// Tests whether a codepoint extends the grapheme cluster before it, and thus belongs to its run.
+    constexpr bool extendsCluster(Grapheme_Cluster_Break graphemeClusterBreak) noexcept
+    {
+        switch (graphemeClusterBreak)
+        {
+            case Grapheme_Cluster_Break::Extend:
+            case Grapheme_Cluster_Break::SpacingMark:
+            case Grapheme_Cluster_Break::ZWJ: return true;
+            default: return false;
+        }
+    }
+} // namespace
+
+bool orientation_segmenter::consume(out<size_t> size, out<TextOrientation> orientation) noexcept
+{
+    if (offset_ >= size_)
+        return false;
+
+    auto const runOrientation = text_orientation(codepoint_properties::get(buffer_[offset_]).vertical_orientation);
+
+    for (++offset_; offset_ < size_; ++offset_)
+    {
+        auto const properties = codepoint_properties::get(buffer_[offset_]);
+        if (!extendsCluster(properties.grapheme_cluster_break)
+            && text_orientation(properties.vertical_orientation) != runOrientation)
+            break;
+    }
+
+    *size = offset_;
+    *orientation = runOrientation;
+    return true;
+}
+
+bool orientation_segmenter::push(Vertical_Orientation verticalOrientation,
+                                 Grapheme_Cluster_Break graphemeClusterBreak,
+                                 out<TextOrientation> endedOrientation) noexcept
+{
+    auto const orientation = text_orientation(verticalOrientation);
+
+    if (!pushedAny_)
+    {
+        pushedAny_ = true;
+        currentOrientation_ = orientation;
+        return true;
+    }
+
+    if (extendsCluster(graphemeClusterBreak) || orientation == currentOrientation_)
+        return true;
+
+    *endedOrientation = currentOrientation_;
+    currentOrientation_ = orientation;
+    return false;
+}
+
+} // namespace unicode
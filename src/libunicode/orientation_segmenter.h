@@ -0,0 +1,121 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <libunicode/support.h>
+#include <libunicode/ucd_enums.h>
+
+#include <format>
+#include <ostream>
+#include <string_view>
+
+namespace unicode
+{
+
+/// How a run of text is set in vertical text layout.
+enum class TextOrientation
+{
+    /// Glyphs stand upright, as is the case for CJK ideographs and kana.
+    Upright,
+
+    /// Glyphs are rotated 90 degrees clockwise, as is the case for Latin text.
+    Sideways,
+};
+
+/// Maps the Vertical_Orientation property (UAX #50) to the orientation a codepoint is set in.
+///
+/// Transformed_Rotated codepoints (such as brackets) have vertical alternates in CJK fonts,
+/// that the shaper picks for upright runs, and are therefore kept upright as well.
+constexpr TextOrientation text_orientation(Vertical_Orientation value) noexcept
+{
+    return value == Vertical_Orientation::Rotated ? TextOrientation::Sideways : TextOrientation::Upright;
+}
+
+/**
+ * orientation_segmenter API for segmenting text into upright and sideways runs for vertical text layout.
+ *
+ * Runs are split by each codepoint's Vertical_Orientation property (UAX #50), except that combining
+ * marks and other grapheme cluster extenders stay in the run of the codepoint they extend.
+ */
+class orientation_segmenter
+{
+  private:
+    char32_t const* buffer_ = U"";
+    size_t size_ = 0;
+    size_t offset_ = 0;
+    TextOrientation currentOrientation_ = TextOrientation::Sideways;
+    bool pushedAny_ = false;
+
+  public:
+    using property_type = TextOrientation;
+
+    constexpr orientation_segmenter() noexcept = default;
+    constexpr orientation_segmenter& operator=(orientation_segmenter const&) noexcept = default;
+    constexpr orientation_segmenter& operator=(orientation_segmenter&&) noexcept = default;
+    constexpr orientation_segmenter(orientation_segmenter const&) noexcept = default;
+    constexpr orientation_segmenter(orientation_segmenter&&) noexcept = default;
+
+    constexpr orientation_segmenter(char32_t const* buffer, size_t size) noexcept: buffer_ { buffer }, size_ { size } {}
+
+    constexpr orientation_segmenter(std::u32string_view const& sv) noexcept: orientation_segmenter(sv.data(), sv.size()) {}
+
+    /// Segments the next run.
+    ///
+    /// @param size        receives the end offset of the run.
+    /// @param orientation receives the orientation the run is set in.
+    ///
+    /// @retval true  a run has been segmented.
+    /// @retval false end of input data has been reached.
+    bool consume(out<size_t> size, out<TextOrientation> orientation) noexcept;
+
+    /// Feeds the next codepoint into the current orientation run, for callers that drive the
+    /// segmentation one codepoint at a time and already know the codepoint's properties
+    /// (see fused_run_segmenter).
+    ///
+    /// @retval true  the codepoint continues the current run.
+    /// @retval false the codepoint opens the next run. The run that ended is set in @p endedOrientation.
+    bool push(Vertical_Orientation verticalOrientation,
+              Grapheme_Cluster_Break graphemeClusterBreak,
+              out<TextOrientation> endedOrientation) noexcept;
+
+    /// Returns the orientation of the current run as far as it has been fed.
+    [[nodiscard]] constexpr TextOrientation currentOrientation() const noexcept { return currentOrientation_; }
+};
+
+inline std::ostream& operator<<(std::ostream& os, TextOrientation value)
+{
+    switch (value)
+    {
+        case TextOrientation::Upright: return os << "Upright";
+        case TextOrientation::Sideways: return os << "Sideways";
+    }
+    return os;
+}
+
+} // namespace unicode
+
+template <>
+struct std::formatter<unicode::TextOrientation>: std::formatter<std::string_view>
+{
+    auto format(unicode::TextOrientation value, auto& ctx) const
+    {
+        string_view name;
+        switch (value)
+        {
+            case unicode::TextOrientation::Upright: name = "Upright"; break;
+            case unicode::TextOrientation::Sideways: name = "Sideways"; break;
+        }
+        return formatter<string_view>::format(name, ctx);
+    }
+};
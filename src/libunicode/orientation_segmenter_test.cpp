@@ -0,0 +1,81 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <libunicode/codepoint_properties.h>
+#include <libunicode/orientation_segmenter.h>
+#include <libunicode/ucd_ostream.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace unicode;
+
+namespace
+{
+void test_orientation_runs(std::u32string_view text, std::vector<std::pair<size_t, TextOrientation>> const& expectations)
+{
+    auto segmenter = orientation_segmenter { text };
+    auto end = size_t { 0 };
+    auto orientation = TextOrientation {};
+    for (auto const& [expectedEnd, expectedOrientation]: expectations)
+    {
+        REQUIRE(segmenter.consume(out(end), out(orientation)));
+        CHECK(end == expectedEnd);
+        CHECK(orientation == expectedOrientation);
+    }
+    CHECK_FALSE(segmenter.consume(out(end), out(orientation)));
+}
+} // namespace
+
+TEST_CASE("orientation_segmenter.vertical_orientation", "[orientation_segmenter]")
+{
+    CHECK(codepoint_properties::get(U'A').vertical_orientation == Vertical_Orientation::Rotated);
+    CHECK(codepoint_properties::get(U'漢').vertical_orientation == Vertical_Orientation::Upright);
+    CHECK(codepoint_properties::get(U'、').vertical_orientation == Vertical_Orientation::Transformed_Upright);
+    CHECK(codepoint_properties::get(U'「').vertical_orientation == Vertical_Orientation::Transformed_Rotated);
+}
+
+TEST_CASE("orientation_segmenter.empty", "[orientation_segmenter]")
+{
+    test_orientation_runs(U""sv, {});
+}
+
+TEST_CASE("orientation_segmenter.LatinHan", "[orientation_segmenter]")
+{
+    test_orientation_runs(U"abc漢字 def"sv,
+                          {
+                              { 3, TextOrientation::Sideways },
+                              { 5, TextOrientation::Upright },
+                              { 9, TextOrientation::Sideways },
+                          });
+}
+
+TEST_CASE("orientation_segmenter.TransformedStaysUpright", "[orientation_segmenter]")
+{
+    // Ideographic comma (Tu) and corner brackets (Tr) are set upright along with the ideographs.
+    test_orientation_runs(U"漢、「字」"sv, { { 5, TextOrientation::Upright } });
+}
+
+TEST_CASE("orientation_segmenter.CombiningMarkKeepsRun", "[orientation_segmenter]")
+{
+    // U+0301 is Rotated on its own, but belongs to the upright cluster it extends.
+    test_orientation_runs(U"漢́a"sv,
+                          {
+                              { 2, TextOrientation::Upright },
+                              { 3, TextOrientation::Sideways },
+                          });
+}
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <libunicode/emoji_segmenter.h>
+#include <libunicode/orientation_segmenter.h>
 #include <libunicode/script_segmenter.h>
 #include <libunicode/support.h>
 #include <libunicode/ucd.h>
@@ -49,6 +50,7 @@ namespace detail
 ///
 /// @see script_segmenter
 /// @see emoji_segmenter
+/// @see orientation_segmenter
 /// @see grapheme_segmenter
 template <typename... Segmenter>
 class basic_run_segmenter
@@ -176,4 +178,10 @@ class basic_run_segmenter
 
 using run_segmenter = basic_run_segmenter<script_segmenter, emoji_segmenter>;
 
+/// Run segmentation for vertical text layout, additionally splitting runs into upright and sideways ones.
+///
+/// See fused_vertical_run_segmenter and utf8_vertical_run_segmenter for the same runs with a single
+/// property lookup per codepoint, the latter directly over UTF-8 text.
+using vertical_run_segmenter = basic_run_segmenter<script_segmenter, emoji_segmenter, orientation_segmenter>;
+
 } // namespace unicode
@@ -11,12 +11,16 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <libunicode/fused_run_segmenter.h>
+#include <libunicode/incremental_run_segmenter.h>
 #include <libunicode/run_segmenter.h>
+#include <libunicode/test_random_text.h>
 #include <libunicode/ucd_ostream.h>
 #include <libunicode/utf8.h>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -65,6 +69,31 @@ void test_run_segmentation(int lineNo, std::vector<Expectation> const& expectati
     }
     bool const consumeFail = segmenter.consume(out(actualSegment));
     REQUIRE_FALSE(consumeFail);
+
+    // The fused segmenter must yield the very same runs.
+    auto fused = unicode::fused_run_segmenter { text };
+    for (size_t i = 0; i < expectations.size(); ++i)
+    {
+        INFO("Line " << lineNo << ": fused run segmentation failed for part " << i);
+        REQUIRE(fused.consume(out(actualSegment)));
+        CHECK(actualSegment == expects[i]);
+    }
+    REQUIRE_FALSE(fused.consume(out(actualSegment)));
+
+    // And so must the UTF-8 one, with its offsets in bytes.
+    auto const utf8Text = to_utf8(text);
+    auto utf8Segmenter = unicode::utf8_run_segmenter { utf8Text };
+    auto utf8Offset = size_t { 0 };
+    for (size_t i = 0; i < expectations.size(); ++i)
+    {
+        INFO("Line " << lineNo << ": UTF-8 run segmentation failed for part " << i);
+        auto const utf8Length = to_utf8(expectations[i].text).size();
+        REQUIRE(utf8Segmenter.consume(out(actualSegment)));
+        CHECK(actualSegment
+              == run_segmenter::range { utf8Offset, utf8Offset + utf8Length, expects[i].properties });
+        utf8Offset += utf8Length;
+    }
+    REQUIRE_FALSE(utf8Segmenter.consume(out(actualSegment)));
 }
 } // namespace
 
@@ -267,3 +296,172 @@ TEST_CASE("run_segmenter.NonEmojiPresentationSymbols", "[run_segmenter]")
                               Script::Common,
                               PresentationStyle::Text } }); // Orientation::Keep
 }
+
+TEST_CASE("vertical_run_segmenter.LatinHanEmoji", "[run_segmenter]")
+{
+    auto const text = U"abc\u6F22\u5B57\U0001F600"sv;
+    auto segmenter = vertical_run_segmenter { text };
+    auto range = vertical_run_segmenter::range {};
+
+    REQUIRE(segmenter.consume(out(range)));
+    CHECK(range.start == 0);
+    CHECK(range.end == 3);
+    CHECK(range.properties
+          == vertical_run_segmenter::property_tuple { Script::Latin, PresentationStyle::Text, TextOrientation::Sideways });
+
+    REQUIRE(segmenter.consume(out(range)));
+    CHECK(range.start == 3);
+    CHECK(range.end == 5);
+    CHECK(range.properties
+          == vertical_run_segmenter::property_tuple { Script::Han, PresentationStyle::Text, TextOrientation::Upright });
+
+    REQUIRE(segmenter.consume(out(range)));
+    CHECK(range.start == 5);
+    CHECK(range.end == 6);
+    CHECK(range.properties
+          == vertical_run_segmenter::property_tuple { Script::Han, PresentationStyle::Emoji, TextOrientation::Upright });
+
+    CHECK_FALSE(segmenter.consume(out(range)));
+}
+
+TEST_CASE("fused_run_segmenter.matches_run_segmenter", "[run_segmenter]")
+{
+    // Script changes, Common/Inherited codepoints, script extensions and every kind of emoji
+    // sequence, shuffled into each other.
+    auto const pieces = std::array<std::u32string_view, 20> {
+        U"abc"sv,          U" "sv,           U"123"sv,         U"\u0301"sv,      U"\u0915\u094D"sv,
+        U"\u0964"sv,       U"\u0627\u0644"sv, U"\u0660"sv,       U"\u4E2D"sv,      U"\u3042"sv,
+        U"\U0001F600"sv,   U"\u2764\uFE0F"sv, U"\u263A\uFE0E"sv, U"\u200D"sv,      U"\U0001F1E9\U0001F1EA"sv,
+        U"#\uFE0F\u20E3"sv, U"\U0001F44D\U0001F3FD"sv, U"\U0001F3F4\U000E0067\U000E0062\U000E007F"sv,
+        U"\u00A9"sv,      U"\u3001"sv,
+    };
+
+    auto randomText = test::random_text_generator { pieces };
+    for (int round = 0; round < 2000; ++round)
+    {
+        auto const text = randomText(15);
+
+        INFO("text: " << to_utf8(text));
+        auto expected = run_segmenter { text };
+        auto fused = fused_run_segmenter { text };
+        auto expectedRange = run_segmenter::range {};
+        auto fusedRange = run_segmenter::range {};
+        while (expected.consume(out(expectedRange)))
+        {
+            REQUIRE(fused.consume(out(fusedRange)));
+            CHECK(fusedRange == expectedRange);
+        }
+        CHECK_FALSE(fused.consume(out(fusedRange)));
+
+        // The UTF-8 segmenter yields the same runs, at the byte offsets of their codepoints.
+        auto const utf8Text = to_utf8(text);
+        auto utf8Segmenter = utf8_run_segmenter { utf8Text };
+        auto utf8Range = run_segmenter::range {};
+        auto reference = run_segmenter { text };
+        while (reference.consume(out(expectedRange)))
+        {
+            REQUIRE(utf8Segmenter.consume(out(utf8Range)));
+            CHECK(utf8Range.start == to_utf8(text.data(), expectedRange.start).size());
+            CHECK(utf8Range.end == to_utf8(text.data(), expectedRange.end).size());
+            CHECK(utf8Range.properties == expectedRange.properties);
+        }
+        CHECK_FALSE(utf8Segmenter.consume(out(utf8Range)));
+
+        // The vertical variants yield the runs of vertical_run_segmenter, from the same lookups.
+        auto expectedVertical = vertical_run_segmenter { text };
+        auto fusedVertical = fused_vertical_run_segmenter { text };
+        auto utf8Vertical = utf8_vertical_run_segmenter { utf8Text };
+        auto expectedVerticalRange = vertical_run_segmenter::range {};
+        auto verticalRange = vertical_run_segmenter::range {};
+        auto utf8VerticalRange = vertical_run_segmenter::range {};
+        while (expectedVertical.consume(out(expectedVerticalRange)))
+        {
+            REQUIRE(fusedVertical.consume(out(verticalRange)));
+            CHECK(verticalRange == expectedVerticalRange);
+
+            REQUIRE(utf8Vertical.consume(out(utf8VerticalRange)));
+            CHECK(utf8VerticalRange.start == to_utf8(text.data(), expectedVerticalRange.start).size());
+            CHECK(utf8VerticalRange.end == to_utf8(text.data(), expectedVerticalRange.end).size());
+            CHECK(utf8VerticalRange.properties == expectedVerticalRange.properties);
+        }
+        CHECK_FALSE(fusedVertical.consume(out(verticalRange)));
+        CHECK_FALSE(utf8Vertical.consume(out(utf8VerticalRange)));
+    }
+}
+
+TEST_CASE("utf8_run_segmenter.invalid", "[run_segmenter]")
+{
+    auto range = run_segmenter::range {};
+
+    // Invalid and truncated sequences are segmented as U+FFFD, which is Common and thus joins its neighbours.
+    auto segmenter = utf8_run_segmenter { "ab\xFF\xC3" "cd\xF0\x9F"sv };
+    REQUIRE(segmenter.consume(out(range)));
+    CHECK(range == run_segmenter::range { 0, 8, { Script::Latin, PresentationStyle::Text } });
+    CHECK_FALSE(segmenter.consume(out(range)));
+
+    // A lead byte interrupting a sequence starts the next codepoint.
+    auto interrupted = utf8_run_segmenter { "a\xE2\xF0\x9F\x98\x80"sv };
+    REQUIRE(interrupted.consume(out(range)));
+    CHECK(range == run_segmenter::range { 0, 2, { Script::Latin, PresentationStyle::Text } });
+    REQUIRE(interrupted.consume(out(range)));
+    CHECK(range == run_segmenter::range { 2, 6, { Script::Latin, PresentationStyle::Emoji } });
+    CHECK_FALSE(interrupted.consume(out(range)));
+}
+
+TEST_CASE("incremental_run_segmenter.hash", "[run_segmenter]")
+{
+    // Equal text with equal properties hashes equally, regardless of where the run is located.
+    auto const runs = segment_runs(U"abc\u4E2Dabc"sv);
+    REQUIRE(runs.size() == 3);
+    CHECK(runs[0].hash == runs[2].hash);
+    CHECK(runs[0].hash == hash_run(U"abc"sv, { Script::Latin, PresentationStyle::Text }));
+    CHECK(runs[0].hash != hash_run(U"abd"sv, { Script::Latin, PresentationStyle::Text }));
+    CHECK(runs[0].hash != hash_run(U"abc"sv, { Script::Latin, PresentationStyle::Emoji }));
+    CHECK(runs[0].hash != runs[1].hash);
+}
+
+TEST_CASE("incremental_run_segmenter.keeps_unaffected_runs", "[run_segmenter]")
+{
+    auto const before = U"abc \u4E2D\u6587 \U0001F600 \u0627\u0644"s;
+    auto runs = segment_runs(before);
+
+    // Replace "abc" by "hello": only the leading Latin run is segmented again.
+    auto const after = U"hello \u4E2D\u6587 \U0001F600 \u0627\u0644"s;
+    auto const [first, last] = resegment_runs(after, text_edit { 0, 3, 5 }, runs);
+    CHECK(first == 0);
+    CHECK(last == 1);
+    CHECK(runs == segment_runs(after));
+}
+
+TEST_CASE("incremental_run_segmenter.matches_segment_runs", "[run_segmenter]")
+{
+    auto const pieces = std::array<std::u32string_view, 12> {
+        U"abc"sv,        U" "sv,           U"123"sv,        U"\u0301"sv,
+        U"\u0915\u094D"sv, U"\u0964"sv,     U"\u0627\u0644"sv, U"\u4E2D"sv,
+        U"\U0001F600"sv, U"\u2764\uFE0F"sv, U"\u200D"sv,       U"#\uFE0F\u20E3"sv,
+    };
+
+    auto randomText = test::random_text_generator { pieces };
+    for (int round = 0; round < 2000; ++round)
+    {
+        auto text = randomText(16);
+        auto runs = segment_runs(text);
+
+        for (int editNo = 0; editNo < 4; ++editNo)
+        {
+            auto const start = randomText.below(text.size() + 1);
+            auto const removedCount = randomText.below(text.size() - start + 1);
+            auto const inserted = randomText(2);
+            auto edited = text;
+            edited.replace(start, removedCount, inserted);
+
+            INFO("before: " << to_utf8(text));
+            INFO("after: " << to_utf8(edited));
+            auto const [first, last] = resegment_runs(edited, text_edit { start, removedCount, inserted.size() }, runs);
+            REQUIRE(runs == segment_runs(edited));
+            CHECK(first <= last);
+            CHECK(last <= runs.size());
+            text = std::move(edited);
+        }
+    }
+}
@@ -150,20 +150,23 @@ scan_result detail::scan_for_text_nonascii(scan_state& state,
             byteCount = 0;
             state.lastCodepointHint = nextCodepoint;
 
+            // Looked up once and shared by the segmenter and the width accumulator below.
+            auto const properties = codepoint_properties::get(nextCodepoint);
+
             bool const breakable = [&] {
                 if (!prevCodepoint)
                 {
-                    grapheme_process_init(nextCodepoint, state.graphemeState);
+                    grapheme_process_init(nextCodepoint, properties, state.graphemeState);
                     return true;
                 }
-                return grapheme_process_breakable(nextCodepoint, state.graphemeState);
+                return grapheme_process_breakable(nextCodepoint, properties, state.graphemeState);
             }();
             if (breakable)
             {
                 // The incoming codepoint opens the next cluster, so it is measured on its own rather
                 // than carrying anything over from the cluster just closed.
                 auto nextCluster = grapheme_cluster_width_accumulator {};
-                nextCluster.push(nextCodepoint);
+                nextCluster.push(nextCodepoint, properties);
                 auto const nextWidth = static_cast<size_t>(nextCluster.width());
 
                 if (count + nextWidth > maxColumnCount)
@@ -187,7 +190,7 @@ scan_result detail::scan_for_text_nonascii(scan_state& state,
                 // The codepoint joins the current cluster, which may widen it (a spacing mark, a
                 // conjunct, VS16) or narrow it (VS15). Only the difference is counted, so a cluster
                 // split across two calls is not measured twice.
-                state.clusterWidth.push(nextCodepoint);
+                state.clusterWidth.push(nextCodepoint, properties);
                 auto const updatedWidth = static_cast<size_t>(state.clusterWidth.width());
 
                 if (updatedWidth >= state.reportedClusterWidth)
@@ -302,9 +305,10 @@ scan_result scan_text(scan_state& state,
                 // only what the mark adds is counted a second time.
                 auto const lastAscii = static_cast<char32_t>(static_cast<uint8_t>(text[count - 1]));
                 state.lastCodepointHint = lastAscii;
-                grapheme_process_init(lastAscii, state.graphemeState);
+                auto const lastAsciiProperties = codepoint_properties::get(lastAscii);
+                grapheme_process_init(lastAscii, lastAsciiProperties, state.graphemeState);
                 state.clusterWidth.reset();
-                state.clusterWidth.push(lastAscii);
+                state.clusterWidth.push(lastAscii, lastAsciiProperties);
                 state.reportedClusterWidth = 1;
 
                 result.count += count;
@@ -85,7 +85,7 @@ size_t scan_for_text_ascii_simd(std::string_view text, size_t maxColumnCount) no
             input += advance;
             break;
         }
-        input += sizeof(simd_size);
+        input += simd_size;
     }
 #endif
 
@@ -11,10 +11,12 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <libunicode/codepoint_properties.h>
 #include <libunicode/script_segmenter.h>
 #include <libunicode/ucd.h>
 
 #include <algorithm>
+#include <bit>
 
 using namespace std;
 
@@ -33,6 +35,55 @@ namespace
             default: return true;
         }
     }
+
+    constexpr bool contains(script_bitset const& bits, Script script) noexcept
+    {
+        auto const value = static_cast<size_t>(script);
+        return (bits[value / 64] >> (value % 64)) & 1;
+    }
+
+    constexpr bool isEmpty(script_bitset const& bits) noexcept
+    {
+        return std::all_of(bits.begin(), bits.end(), [](uint64_t word) { return word == 0; });
+    }
+
+    constexpr size_t countOf(script_bitset const& bits) noexcept
+    {
+        auto count = size_t { 0 };
+        for (auto const word: bits)
+            count += static_cast<size_t>(std::popcount(word));
+        return count;
+    }
+
+    /// Returns the script of the lowest value in @p bits, or Script::Invalid if empty.
+    constexpr Script lowestOf(script_bitset const& bits) noexcept
+    {
+        for (size_t i = 0; i < bits.size(); ++i)
+            if (bits[i])
+                return static_cast<Script>(i * 64 + static_cast<size_t>(std::countr_zero(bits[i])));
+        return Script::Invalid;
+    }
+
+    constexpr script_bitset intersect(script_bitset a, script_bitset const& b) noexcept
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] &= b[i];
+        return a;
+    }
+
+    constexpr script_bitset unite(script_bitset a, script_bitset const& b) noexcept
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] |= b[i];
+        return a;
+    }
+
+    constexpr script_bitset without(script_bitset bits, Script script) noexcept
+    {
+        auto const value = static_cast<size_t>(script);
+        bits[value / 64] &= ~(uint64_t { 1 } << (value % 64));
+        return bits;
+    }
 } // namespace
 
 optional<script_segmenter::result> script_segmenter::consume()
@@ -42,7 +93,8 @@ optional<script_segmenter::result> script_segmenter::consume()
 
     while (offset_ < size_)
     {
-        ScriptSet const nextScriptSet = getScriptsFor(currentChar());
+        auto const& properties = codepoint_properties::get(currentChar());
+        ScriptSet const nextScriptSet = getScriptsFor(properties.script, properties.script_extensions_id);
 
         if (!mergeSets(nextScriptSet, currentScriptSet_))
         {
@@ -56,24 +108,40 @@ optional<script_segmenter::result> script_segmenter::consume()
     }
 
     auto const res = result { resolveScript(), offset_ };
-    currentScriptSet_.clear();
+    currentScriptSet_ = {};
     return res;
 }
 
+bool script_segmenter::push(Script script, uint8_t extensionsId, out<Script> endedScript) noexcept
+{
+    ScriptSet const nextScriptSet = getScriptsFor(script, extensionsId);
+    if (mergeSets(nextScriptSet, currentScriptSet_))
+        return true;
+
+    *endedScript = resolveScript();
+    currentScriptSet_ = nextScriptSet;
+    return false;
+}
+
 bool script_segmenter::mergeSets(ScriptSet const& nextSet, ScriptSet& currentSet) noexcept
 {
-    if (nextSet.empty() || currentSet.empty())
+    if (isEmpty(nextSet.scripts) || isEmpty(currentSet.scripts))
         return false;
 
-    auto currentSetIter = currentSet.begin();
-    auto const currentSetEnd = currentSet.end();
+    auto priorityScript = currentSet.first;
 
-    Script priorityScript = *currentSetIter++;
+    // The common case of yet another codepoint of the script the run already resolved to.
+    if (nextSet.first == priorityScript && isPreferred(priorityScript)
+        && nextSet.scripts == ScriptSet::of(priorityScript).scripts)
+    {
+        currentSet = nextSet;
+        return true;
+    }
 
-    if (!isPreferred(nextSet.at(0)))
+    if (!isPreferred(nextSet.first))
     {
-        if (nextSet.size() == 2 && !isPreferred(priorityScript) && commonPreferredScript_ == Script::Common)
-            commonPreferredScript_ = nextSet.at(1);
+        if (countOf(nextSet.scripts) == 2 && !isPreferred(priorityScript) && commonPreferredScript_ == Script::Common)
+            commonPreferredScript_ = lowestOf(without(nextSet.scripts, nextSet.first));
         return true;
     }
 
@@ -84,65 +152,43 @@ bool script_segmenter::mergeSets(ScriptSet const& nextSet, ScriptSet& currentSet
         return true;
     }
 
-    auto nextSetIter = nextSet.begin();
-    auto const nextSetEnd = nextSet.end();
-
-    if (currentSetIter == currentSetEnd)
-        return std::find(nextSetIter, nextSetEnd, priorityScript) != nextSetEnd;
+    auto const currentRest = without(currentSet.scripts, priorityScript);
+    if (isEmpty(currentRest))
+        return contains(nextSet.scripts, priorityScript);
 
     // See if we have a priority script, and if not, get it from the nextScriptSet
-    bool hasPriorityScript = find(nextSetIter, nextSetEnd, priorityScript) != nextSetEnd;
+    auto nextRest = nextSet.scripts;
+    bool hasPriorityScript = contains(nextSet.scripts, priorityScript);
     if (!hasPriorityScript)
     {
-        priorityScript = *nextSetIter++;
-        hasPriorityScript = find(currentSetIter, currentSetEnd, priorityScript) != currentSetEnd;
+        priorityScript = nextSet.first;
+        nextRest = without(nextRest, priorityScript);
+        hasPriorityScript = contains(currentRest, priorityScript);
     }
 
-    auto currentWriteIter = currentSet.begin();
+    // Intersect the remaining nextScriptSet into the remaining currentSet.
+    auto const intersection = intersect(currentRest, nextRest);
     if (hasPriorityScript)
-        *currentWriteIter++ = priorityScript;
-
-    // Intersect the remaining nextScriptSet into the currentSetIter.
-    if (nextSetIter != nextSetEnd)
-    {
-        while (currentSetIter != currentSetEnd)
-        {
-            auto const sc = *currentSetIter++;
-            if (find(nextSetIter, nextSetEnd, sc) != nextSetEnd)
-                *currentWriteIter++ = sc;
-        }
-    }
-
-    // NB: first is always smaller than second, so it is save to cast to unsigned.
-    auto const writeCount = static_cast<size_t>(distance(currentSet.begin(), currentWriteIter));
-    if (writeCount == 0)
+        currentSet = ScriptSet { priorityScript, unite(intersection, ScriptSet::of(priorityScript).scripts) };
+    else if (!isEmpty(intersection))
+        currentSet = ScriptSet { lowestOf(intersection), intersection };
+    else
         return false;
 
-    currentSet.resize(writeCount);
     return true;
 }
 
-script_segmenter::ScriptSet script_segmenter::getScriptsFor(char32_t codepoint) noexcept
+script_segmenter::ScriptSet script_segmenter::getScriptsFor(Script sc, uint8_t extensionsId) noexcept
 {
-    ScriptSet scriptSet;
-    Script const sc = script(codepoint);
-
-    // Collect all script extensions for @p codepoint into scriptSet.
-    if (auto const exts = script_extensions(codepoint))
-        for (auto const s: *exts)
-            scriptSet.push_back(s);
-    else
-        scriptSet.push_back(sc);
-
-    // If the script of @p codepoint is also in scriptSet,
-    // then move it to the front of the set,
-    // otherwise append it to the back of scriptSet.
-    if (auto i = find(scriptSet.begin(), scriptSet.end(), sc); i != scriptSet.end())
-        swap(*i, *scriptSet.begin());
-    else
-        scriptSet.push_back(sc);
-
-    return scriptSet;
+    if (!extensionsId)
+        return ScriptSet::of(sc);
+
+    // The codepoint's script leads the set if it is one of its script extensions,
+    // otherwise it is added to them.
+    auto const& extensions = script_extensions_bitset(extensionsId);
+    if (contains(extensions, sc))
+        return ScriptSet { sc, extensions };
+    return ScriptSet { lowestOf(extensions), unite(extensions, ScriptSet::of(sc).scripts) };
 }
 
 } // namespace unicode
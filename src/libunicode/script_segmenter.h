@@ -16,6 +16,7 @@
 #include <libunicode/support.h>
 #include <libunicode/ucd.h>
 
+#include <cstdint>
 #include <optional>
 #include <string_view>
 
@@ -33,14 +34,14 @@ class script_segmenter
 
     constexpr explicit script_segmenter(char32_t const* data) noexcept: script_segmenter { data, getStringLength(data) } {}
 
-    constexpr script_segmenter(char32_t const* data, size_t size) noexcept: data_ { data }, offset_ { 0 }, size_ { size }
+    constexpr script_segmenter(char32_t const* data, size_t size) noexcept:
+        data_ { data }, offset_ { 0 }, size_ { size }, currentScriptSet_ { ScriptSet::of(Script::Common) }
     {
-        currentScriptSet_.push_back(Script::Common);
     }
 
-    constexpr script_segmenter(std::u32string_view data) noexcept: data_ { data.data() }, offset_ { 0 }, size_ { data.size() }
+    constexpr script_segmenter(std::u32string_view data) noexcept:
+        data_ { data.data() }, offset_ { 0 }, size_ { data.size() }, currentScriptSet_ { ScriptSet::of(Script::Common) }
     {
-        currentScriptSet_.push_back(Script::Common);
     }
 
     struct result
@@ -64,8 +65,38 @@ class script_segmenter
         return false;
     }
 
+    /// Feeds the next codepoint into the current script run, for callers that drive the
+    /// segmentation one codepoint at a time instead of handing over a buffer, and that already
+    /// looked up the codepoint's @p script and @p extensionsId, the id of its Script_Extensions
+    /// (see codepoint_properties and fused_run_segmenter).
+    ///
+    /// @retval true  the codepoint continues the current run.
+    /// @retval false a script boundary precedes the codepoint, which opens the next run.
+    ///               The run that ended resolved to @p endedScript.
+    bool push(Script script, uint8_t extensionsId, out<Script> endedScript) noexcept;
+
+    /// Returns the resolved script of the current run as far as it has been fed.
+    constexpr Script currentScript() const noexcept { return resolveScript(); }
+
   private:
-    using ScriptSet = fs_array<Script, 32>;
+    /// The scripts a run may still be attributed to.
+    struct ScriptSet
+    {
+        /// The script the run resolves to, one of @c scripts.
+        Script first = Script::Invalid;
+
+        /// All candidate scripts, as bitset indexed by Script value. Empty if no script is left.
+        script_bitset scripts {};
+
+        /// Returns the set of @p script alone.
+        static constexpr ScriptSet of(Script script) noexcept
+        {
+            auto set = ScriptSet { script, {} };
+            auto const value = static_cast<size_t>(script);
+            set.scripts[value / 64] = uint64_t { 1 } << (value % 64);
+            return set;
+        }
+    };
 
     /// constexpr-version of strlen for UTF-32 strings
     constexpr size_t getStringLength(char32_t const* data) noexcept
@@ -79,8 +110,9 @@ class script_segmenter
         return n;
     }
 
-    /// Returnes all scripts that this @p _codepoint is associated with.
-    ScriptSet getScriptsFor(char32_t codepoint) noexcept;
+    /// Returns all scripts that a codepoint of Script property @p script and Script_Extensions
+    /// set @p extensionsId is associated with.
+    static ScriptSet getScriptsFor(Script script, uint8_t extensionsId) noexcept;
 
     /// Intersects @p _nextSet into @p _currentSet.
     ///
@@ -94,7 +126,7 @@ class script_segmenter
     /// whatever currentScriptSet's one and only element contains.
     constexpr Script resolveScript() const noexcept
     {
-        Script const result = currentScriptSet_.at(0);
+        Script const result = currentScriptSet_.first;
         return result == Script::Common ? commonPreferredScript_ : result;
     }
 
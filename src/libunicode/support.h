@@ -59,6 +59,28 @@ class out
     T* _ref;
 };
 
+// Incremental 64-bit FNV-1a hash over a sequence of codepoints.
+//
+// Each codepoint contributes its 32-bit scalar value, so the resulting hash only
+// depends on the codepoints and not on the encoding they were read from.
+class codepoint_hasher
+{
+  public:
+    constexpr void operator()(char32_t codepoint) noexcept
+    {
+        for (auto i = 0; i < 4; ++i)
+        {
+            _hash ^= (static_cast<uint32_t>(codepoint) >> (i * 8)) & 0xFF;
+            _hash *= 1099511628211ULL;
+        }
+    }
+
+    [[nodiscard]] constexpr uint64_t value() const noexcept { return _hash; }
+
+  private:
+    uint64_t _hash = 14695981039346656037ULL;
+};
+
 // dynamic array with a fixed capacity.
 template <typename T, std::size_t N>
 class fs_array
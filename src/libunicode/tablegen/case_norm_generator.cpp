@@ -366,4 +366,25 @@ namespace unicode::detail
     out << "} // namespace unicode::detail\n";
 }
 
+size_t maxFullDecompositionLength(UcdParser const& parser, bool compatibility)
+{
+    auto const& decomps = parser.decompositions();
+    auto const expandedLength = [&](auto const& self, char32_t cp) -> size_t {
+        auto const it = decomps.find(cp);
+        if (it == decomps.end() || (!compatibility && it->second.type != "canonical"))
+            return 1;
+        size_t length = 0;
+        for (auto const target: it->second.targets)
+            length += self(self, target);
+        return length;
+    };
+
+    // Hangul syllables are not listed in UnicodeData.txt; they decompose algorithmically into up to
+    // three jamo.
+    size_t maxLength = 3;
+    for (auto const& [cp, d]: decomps)
+        maxLength = std::max(maxLength, expandedLength(expandedLength, cp));
+    return maxLength;
+}
+
 } // namespace tablegen
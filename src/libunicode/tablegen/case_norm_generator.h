@@ -13,6 +13,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace tablegen
@@ -23,4 +24,8 @@ class UcdParser;
 /// Generates case_normalization_data.h from parsed UCD data.
 void generateCaseNormFile(UcdParser const& parser, std::string const& outputDir);
 
+/// Returns the maximum number of codepoints any single codepoint fully (recursively) decomposes to,
+/// using canonical decompositions only, or compatibility decompositions as well.
+[[nodiscard]] size_t maxFullDecompositionLength(UcdParser const& parser, bool compatibility);
+
 } // namespace tablegen
@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 
+#include "case_norm_generator.h"
 #include "enum_utils.h"
 #include "ucd_parser.h"
 
@@ -187,17 +188,7 @@ namespace
         {
             EnumDef def;
             def.name = "Script";
-            def.members.push_back("Invalid");
-            def.members.push_back("Unknown");
-            def.members.push_back("Common");
-            std::set<std::string> scriptSet;
-            for (auto const& r: parser.scripts())
-                scriptSet.insert(r.property);
-            for (auto const& s: scriptSet) // set is sorted
-            {
-                if (s != "Common")
-                    def.members.push_back(s);
-            }
+            def.members = scriptEnumMembers(parser);
             enums.push_back(std::move(def));
         }
 
@@ -228,6 +219,20 @@ namespace
 
 } // anonymous namespace
 
+std::vector<std::string> scriptEnumMembers(UcdParser const& parser)
+{
+    auto members = std::vector<std::string> { "Invalid", "Unknown", "Common" };
+    std::set<std::string> scriptSet;
+    for (auto const& r: parser.scripts())
+        scriptSet.insert(r.property);
+    for (auto const& s: scriptSet) // set is sorted
+    {
+        if (s != "Common")
+            members.push_back(s);
+    }
+    return members;
+}
+
 void generateEnumFiles(UcdParser const& parser, std::string const& outputDir)
 {
     auto enums = collectEnums(parser);
@@ -238,11 +243,20 @@ void generateEnumFiles(UcdParser const& parser, std::string const& outputDir)
         out << licenseHeader;
         out << "#pragma once\n";
         out << "\n";
+        out << "#include <cstddef>\n";
         out << "#include <cstdint>\n";
         out << "\n";
         out << "namespace unicode\n{\n\n";
         for (auto const& def: enums)
             writeEnumClass(out, def);
+        // Emitted here rather than with the decomposition tables, so that callers of normalization.h
+        // can size their buffers without pulling in the tables.
+        out << "/// Maximum number of codepoints in the full canonical decomposition of a single codepoint.\n";
+        out << std::format("inline constexpr size_t MaxCanonicalDecompositionLength = {};\n\n",
+                           maxFullDecompositionLength(parser, false));
+        out << "/// Maximum number of codepoints in the full compatibility decomposition of a single codepoint.\n";
+        out << std::format("inline constexpr size_t MaxCompatibilityDecompositionLength = {};\n\n",
+                           maxFullDecompositionLength(parser, true));
         out << "} // namespace unicode\n";
     }
 
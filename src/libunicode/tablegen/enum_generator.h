@@ -24,4 +24,8 @@ class UcdParser;
 /// Generates ucd_enums.h, ucd_ostream.h, and ucd_fmt.h from parsed UCD data.
 void generateEnumFiles(UcdParser const& parser, std::string const& outputDir);
 
+/// Returns the members of the generated Script enum in the order of their values: Invalid, Unknown
+/// and Common first, then all other scripts sorted by name.
+[[nodiscard]] std::vector<std::string> scriptEnumMembers(UcdParser const& parser);
+
 } // namespace tablegen
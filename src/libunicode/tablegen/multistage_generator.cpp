@@ -25,7 +25,9 @@
 #include <string>
 #include <vector>
 
+#include "enum_generator.h"
 #include "enum_utils.h"
+#include "ucd_api_generator.h"
 #include "ucd_parser.h"
 
 namespace tablegen
@@ -86,10 +88,12 @@ namespace
         uint8_t age = 0;
         uint8_t indic_conjunct_break = 3; // Default: Indic_Conjunct_Break::None
         uint8_t word_break = 18;          // Default: Word_Break::Other
+        uint8_t vertical_orientation = 0; // Default: Vertical_Orientation::Rotated
+        uint8_t script_extensions_id = 0; // Default: none
     };
 #pragma pack(pop)
 
-    static_assert(sizeof(CodepointRecord) == 11, "CodepointRecord must be exactly 11 bytes");
+    static_assert(sizeof(CodepointRecord) == 13, "CodepointRecord must be exactly 13 bytes");
 
     inline bool operator==(CodepointRecord const& a, CodepointRecord const& b) noexcept
     {
@@ -127,19 +131,11 @@ namespace
         return result;
     }
 
-    auto buildScriptIndex(std::vector<PropertyRange> const& scripts) -> std::map<std::string, uint8_t>
+    auto buildScriptIndex(std::vector<std::string> const& scriptNames) -> std::map<std::string, uint8_t>
     {
         std::map<std::string, uint8_t> result;
-        result["Invalid"] = 0;
-        result["Unknown"] = 1;
-        result["Common"] = 2;
-        std::set<std::string> scriptSet;
-        for (auto const& r: scripts)
-            scriptSet.insert(r.property);
-        uint8_t idx = 3;
-        for (auto const& s: scriptSet)
-            if (s != "Common")
-                result[s] = idx++;
+        for (auto const& s: scriptNames)
+            result.emplace(s, static_cast<uint8_t>(result.size()));
         return result;
     }
 
@@ -216,21 +212,6 @@ namespace
 
     // ---- Name mappings for output ----
 
-    auto buildScriptNames(std::vector<PropertyRange> const& scripts) -> std::vector<std::string>
-    {
-        std::vector<std::string> result;
-        result.push_back("Invalid");
-        result.push_back("Unknown");
-        result.push_back("Common");
-        std::set<std::string> scriptSet;
-        for (auto const& r: scripts)
-            scriptSet.insert(r.property);
-        for (auto const& s: scriptSet)
-            if (s != "Common")
-                result.push_back(s);
-        return result;
-    }
-
     auto buildGeneralCategoryNames(std::vector<PropertyRange> const& gcats) -> std::vector<std::string>
     {
         std::vector<std::string> result;
@@ -342,16 +323,17 @@ void generateMultistageFiles(UcdParser const& parser, std::string const& outputD
     };
 
     // Build enum indices matching the generated ucd_enums.h exactly
-    auto const scriptIndex = buildScriptIndex(parser.scripts());
+    auto const scriptNames = scriptEnumMembers(parser);
+    auto const scriptIndex = buildScriptIndex(scriptNames);
     auto const gcIndex = buildGeneralCategoryIndex(parser.generalCategories());
     auto const eawIndex = buildPvaBasedIndex(findPva("East_Asian_Width"));
     auto const ageIndex = buildAgeIndex(findPva("Age"));
     auto const gcbIndex = buildPvaBasedIndex(findPva("Grapheme_Cluster_Break"), "Undefined");
     auto const incbIndex = buildPvaBasedIndex(findPva("Indic_Conjunct_Break"));
     auto const wbIndex = buildPvaBasedIndex(findPva("Word_Break"));
+    auto const voIndex = buildPvaBasedIndex(findPva("Vertical_Orientation"));
 
     // Name vectors for output
-    auto const scriptNames = buildScriptNames(parser.scripts());
     auto const gcNames = buildGeneralCategoryNames(parser.generalCategories());
     auto const ageNames = buildAgeEnumMembers(findPva("Age"));
 
@@ -397,6 +379,7 @@ void generateMultistageFiles(UcdParser const& parser, std::string const& outputD
         auto gcUnassigned = gcIndex.count("Unassigned") ? gcIndex.at("Unassigned") : uint8_t(0);
         auto incbNone = incbIndex.count("None") ? incbIndex.at("None") : uint8_t(3);
         auto wbOther = wbIndex.count("Other") ? wbIndex.at("Other") : uint8_t(18);
+        auto voRotated = voIndex.count("Rotated") ? voIndex.at("Rotated") : uint8_t(0);
         for (auto& rec: records)
         {
             rec.script = scriptUnknown;
@@ -405,6 +388,7 @@ void generateMultistageFiles(UcdParser const& parser, std::string const& outputD
             rec.general_category = gcUnassigned;
             rec.indic_conjunct_break = incbNone;
             rec.word_break = wbOther;
+            rec.vertical_orientation = voRotated;
         }
     }
 
@@ -528,6 +512,27 @@ void generateMultistageFiles(UcdParser const& parser, std::string const& outputD
         }
     }
 
+    // Vertical Orientation
+    for (auto const& r: parser.verticalOrientations())
+    {
+        auto it = voIndex.find(r.property);
+        if (it == voIndex.end())
+            continue;
+        for (auto cp = r.first; cp <= r.last; ++cp)
+            records[static_cast<size_t>(cp)].vertical_orientation = it->second;
+    }
+
+    // Script Extensions, as the id of the distinct set (see script_extensions_bitset() in ucd.h)
+    {
+        auto const sets = distinctScriptExtensionSets(parser);
+        for (auto const& r: parser.scriptExtensions())
+        {
+            auto const id = static_cast<uint8_t>(std::distance(sets.begin(), std::find(sets.begin(), sets.end(), r.properties)) + 1);
+            for (auto cp = r.first; cp <= r.last; ++cp)
+                records[static_cast<size_t>(cp)].script_extensions_id = id;
+        }
+    }
+
     // East Asian Width
     for (auto const& r: parser.eastAsianWidths())
     {
@@ -620,7 +625,7 @@ void generateMultistageFiles(UcdParser const& parser, std::string const& outputD
     // ---- Generate multistage tables ----
     std::cout << "[tablegen]   Generating multistage tables (properties)...\n";
 
-    // FNV-1a hasher for CodepointRecord (trivially copyable, 8 bytes)
+    // FNV-1a hasher for CodepointRecord (trivially copyable, 13 bytes)
     struct RecordHasher
     {
         size_t operator()(CodepointRecord const& r) const noexcept
@@ -698,7 +703,9 @@ void generateMultistageFiles(UcdParser const& parser, std::string const& outputD
              << "EmojiSegmentationCategory::" << escName(rec.emoji_segmentation_category) << ", "
              << "Age::" << (rec.age < ageNames.size() ? ageNames[rec.age] : "Unassigned") << ", "
              << "Indic_Conjunct_Break::" << reverseLookup(incbIndex, rec.indic_conjunct_break, "None") << ", "
-             << "Word_Break::" << reverseLookup(wbIndex, rec.word_break, "Other") << "},\n";
+             << "Word_Break::" << reverseLookup(wbIndex, rec.word_break, "Other") << ", "
+             << "Vertical_Orientation::" << reverseLookup(voIndex, rec.vertical_orientation, "Rotated") << ", "
+             << static_cast<unsigned>(rec.script_extensions_id) << "},\n";
     }
     impl << "}};\n\n";
 
@@ -14,12 +14,16 @@
 #include "ucd_api_generator.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <format>
 #include <fstream>
 #include <map>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "enum_generator.h"
 #include "enum_utils.h"
 #include "ucd_parser.h"
 
@@ -112,6 +116,8 @@ void generateUcdApiFiles(UcdParser const& parser, std::string const& outputDir)
 
 #include <libunicode/ucd_enums.h>
 
+#include <array>
+#include <cstdint>
 #include <optional>
 #include <span>
 #include <string>
@@ -350,6 +356,35 @@ namespace unicode
                                 key,
                                 sce.comment);
         }
+        impl << "} };\n\n";
+
+        // Script values, in the order of the Script enum.
+        auto scriptValues = std::map<std::string, size_t> {};
+        for (auto const& name: scriptEnumMembers(parser))
+            scriptValues.emplace(name, scriptValues.size());
+        auto const bitsetWords = (scriptValues.size() + 63) / 64;
+
+        // Each distinct set gets an id (0 standing for none), which codepoint_properties holds,
+        // and a bitset of its scripts.
+        auto const sets = distinctScriptExtensionSets(parser);
+        impl << std::format("static const std::array<script_bitset, {}> sce_bitsets {{ {{\n", sets.size() + 1);
+        impl << "    script_bitset {}, // none\n";
+        for (auto const& set: sets)
+        {
+            auto words = std::vector<uint64_t>(bitsetWords, 0);
+            auto key = std::string("sce");
+            for (auto const& scriptAbbrev: set)
+            {
+                auto it = pva.find(scriptAbbrev);
+                auto const value = scriptValues.at((it != pva.end()) ? it->second : scriptAbbrev);
+                words[value / 64] |= uint64_t { 1 } << (value % 64);
+                key += "_" + scriptAbbrev;
+            }
+            impl << "    script_bitset { ";
+            for (auto const word: words)
+                impl << std::format("0x{:016X}, ", word);
+            impl << std::format("}}, // {}\n", key);
+        }
         impl << "} };\n";
         impl << std::format("}} // {}\n\n", FOLD_CLOSE);
 
@@ -361,6 +396,15 @@ namespace unicode
         impl << "        return std::nullopt;\n";
         impl << "    return std::span<Script const>{ p->first, p->second };\n";
         impl << "}\n\n";
+
+        header << "/// Set of scripts, with bit N (of word N / 64) standing for the Script of value N.\n";
+        header << std::format("using script_bitset = std::array<uint64_t, {}>;\n\n", bitsetWords);
+        header << "/// Returns the scripts of the Script_Extensions set with the given @p id (none for 0),\n";
+        header << "/// as found in codepoint_properties::script_extensions_id.\n";
+        header << "script_bitset const& script_extensions_bitset(uint8_t id) noexcept;\n\n";
+        impl << "script_bitset const& script_extensions_bitset(uint8_t id) noexcept {\n";
+        impl << "    return tables::sce_bitsets[id];\n";
+        impl << "}\n\n";
     }
 
     // ---- Blocks ----
@@ -616,4 +660,17 @@ namespace unicode
     impl << "} // namespace unicode\n";
 }
 
+std::vector<std::vector<std::string>> distinctScriptExtensionSets(UcdParser const& parser)
+{
+    auto sets = std::vector<std::vector<std::string>> {};
+    for (auto const& sce: parser.scriptExtensions())
+        if (std::find(sets.begin(), sets.end(), sce.properties) == sets.end())
+            sets.push_back(sce.properties);
+
+    if (sets.size() > 255)
+        throw std::runtime_error("Too many distinct script extension sets for an 8-bit id.");
+
+    return sets;
+}
+
 } // namespace tablegen
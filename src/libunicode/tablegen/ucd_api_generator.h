@@ -14,6 +14,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace tablegen
 {
@@ -23,4 +24,8 @@ class UcdParser;
 /// Generates ucd.h and ucd.cpp from parsed UCD data.
 void generateUcdApiFiles(UcdParser const& parser, std::string const& outputDir);
 
+/// Returns the distinct Script_Extensions sets, as lists of script short names, in the order of
+/// their ids: the set of id N is at index N - 1, and id 0 stands for none.
+[[nodiscard]] std::vector<std::vector<std::string>> distinctScriptExtensionSets(UcdParser const& parser);
+
 } // namespace tablegen
@@ -206,6 +206,7 @@ void UcdParser::parseAll()
     loadWordBreakProps();
     loadEastAsianWidths();
     loadHangulSyllableType();
+    loadVerticalOrientations();
     loadEmojiProps();
     loadEmojiVariationSequences();
     loadBidiMirrored();
@@ -475,6 +476,13 @@ void UcdParser::loadHangulSyllableType()
     _hangulSyllableType = loadGenericProperties(_ucdDir + "/HangulSyllableType.txt");
 }
 
+// ---- Vertical Orientation ----
+
+void UcdParser::loadVerticalOrientations()
+{
+    _verticalOrientations = loadGenericProperties(_ucdDir + "/VerticalOrientation.txt");
+}
+
 // ---- Emoji Properties ----
 
 void UcdParser::loadEmojiProps()
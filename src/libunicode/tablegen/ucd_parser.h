@@ -129,6 +129,9 @@ class UcdParser
     /// Hangul Syllable Type ranges (L, V, T, LV, LVT), sorted by start codepoint.
     [[nodiscard]] auto const& hangulSyllableType() const noexcept { return _hangulSyllableType; }
 
+    /// Vertical Orientation ranges (R, U, Tr, Tu), sorted by start codepoint.
+    [[nodiscard]] auto const& verticalOrientations() const noexcept { return _verticalOrientations; }
+
     /// Emoji properties grouped by property name.
     [[nodiscard]] auto const& emojiProps() const noexcept { return _emojiProps; }
 
@@ -188,6 +191,7 @@ class UcdParser
     void loadWordBreakProps();
     void loadEastAsianWidths();
     void loadHangulSyllableType();
+    void loadVerticalOrientations();
     void loadEmojiProps();
     void loadEmojiVariationSequences();
     void loadBidiMirrored();
@@ -251,6 +255,9 @@ class UcdParser
     // Hangul Syllable Type
     std::vector<PropertyRange> _hangulSyllableType;
 
+    // Vertical Orientation
+    std::vector<PropertyRange> _verticalOrientations;
+
     // Emoji
     std::map<std::string, std::vector<PropertyRange>> _emojiProps;
     std::vector<char32_t> _emojiVariationBases;
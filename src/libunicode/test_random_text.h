@@ -0,0 +1,62 @@
+/**
+ * This file is part of the "libunicode" project
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace unicode::test
+{
+
+/// Generates random texts for the tests that compare an implementation against a simpler reference.
+///
+/// A text is a concatenation of pieces picked from a fixed list, chosen to hit the cases that matter
+/// to the code under test. The generator always starts from the same seed, so a failing text is
+/// reproduced on every run.
+template <typename Char>
+class random_text_generator
+{
+  public:
+    using string_view_type = std::basic_string_view<Char>;
+    using string_type = std::basic_string<Char>;
+
+    /// Picks pieces out of @p pieces, which has to outlive the generator.
+    explicit random_text_generator(std::span<string_view_type const> pieces) noexcept: _pieces { pieces } {}
+
+    /// Returns a text of up to @p maxPieces pieces.
+    string_type operator()(size_t maxPieces)
+    {
+        auto text = string_type {};
+        auto const count = below(maxPieces + 1);
+        for (size_t i = 0; i < count; ++i)
+            text += _pieces[below(_pieces.size())];
+        return text;
+    }
+
+    /// Returns a number less than @p bound, e.g. to pick a position in a text.
+    size_t below(size_t bound) { return _rng() % bound; }
+
+  private:
+    std::span<string_view_type const> _pieces;
+    std::mt19937 _rng { 4711 };
+};
+
+template <typename Char, size_t N>
+random_text_generator(std::array<std::basic_string_view<Char>, N> const&) -> random_text_generator<Char>;
+
+} // namespace unicode::test
@@ -11,11 +11,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <libunicode/codepoint_properties.h>
 #include <libunicode/ucd.h>
 
 #include <catch2/catch_test_macros.hpp>
 
 #include <algorithm>
+#include <bit>
 
 using namespace unicode;
 
@@ -44,3 +46,38 @@ TEST_CASE("script_extensions.stable_pointer", "[script_extensions]")
     REQUIRE(b.has_value());
     CHECK(a->data() == b->data());
 }
+
+TEST_CASE("script_extensions.bitset", "[script_extensions]")
+{
+    auto const hasScript = [](script_bitset const& bits, Script script) {
+        auto const value = static_cast<size_t>(script);
+        return ((bits[value / 64] >> (value % 64)) & 1) != 0;
+    };
+
+    auto const extensionsId = [](char32_t codepoint) {
+        return codepoint_properties::get(codepoint).script_extensions_id;
+    };
+
+    CHECK(extensionsId(U'A') == 0);
+    CHECK(script_extensions_bitset(0) == script_bitset {});
+
+    // Every codepoint with script extensions has the id of a bitset holding exactly these scripts.
+    for (char32_t const codepoint: { U'\u0964', U'\u3001', U'\u30FC', U'\u0640', U'\u1CD0' })
+    {
+        auto const exts = script_extensions(codepoint);
+        REQUIRE(exts.has_value());
+        auto const id = extensionsId(codepoint);
+        REQUIRE(id != 0);
+        auto const& bits = script_extensions_bitset(id);
+        auto count = size_t { 0 };
+        for (auto const word: bits)
+            count += static_cast<size_t>(std::popcount(word));
+        CHECK(count == exts->size());
+        for (auto const script: *exts)
+            CHECK(hasScript(bits, script));
+    }
+
+    // Codepoints sharing a set of script extensions share its id.
+    CHECK(extensionsId(U'\u3001') == extensionsId(U'\u3002'));
+    CHECK(extensionsId(U'\u3001') != extensionsId(U'\u0964'));
+}
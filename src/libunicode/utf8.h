@@ -148,6 +148,41 @@ inline ConvertResult from_utf8(char const* bytes, size_t* size)
     return from_utf8((uint8_t const*) (bytes), size);
 }
 
+/// A codepoint decoded from UTF-8, along with the number of bytes it was decoded from.
+struct utf8_decode_result
+{
+    char32_t codepoint;
+    size_t length;
+};
+
+/// Decodes the first codepoint of the non-empty UTF-8 text @p text, replacing invalid input with U+FFFD.
+///
+/// An invalid or truncated sequence decodes to a single U+FFFD spanning the bytes read up to where it
+/// turned out to be invalid, except that a lead byte cutting a sequence short is left to begin the
+/// next codepoint. Decoding a text from front to back this way never skips a valid codepoint.
+inline utf8_decode_result decode_utf8(std::string_view text) noexcept
+{
+    auto constexpr ReplacementChar = char32_t { 0xFFFD };
+
+    auto const lead = static_cast<uint8_t>(text[0]);
+    if (lead < 0x80)
+        return { lead, 1 };
+
+    auto state = utf8_decoder_state {};
+    auto length = size_t { 1 };
+    auto result = from_utf8(state, lead);
+    while (std::holds_alternative<Incomplete>(result) && length < text.size())
+        result = from_utf8(state, static_cast<uint8_t>(text[length++]));
+
+    if (auto const* success = std::get_if<Success>(&result))
+        return { success->value, length };
+
+    if (std::holds_alternative<Invalid>(result) && state.expectedLength != 0)
+        --length; // from_utf8() has already begun the next codepoint with this lead byte
+
+    return { ReplacementChar, length };
+}
+
 namespace detail
 {
     // Forward declaration of SIMD-accelerated UTF-8 -> UTF-32 dispatcher (defined in convert.cpp).
@@ -14,7 +14,10 @@
 #include <libunicode/convert.h>
 #include <libunicode/grapheme_segmenter.h>
 #include <libunicode/utf8.h>
+#include <libunicode/width.h>
 
+#include <cstddef>
+#include <iterator>
 #include <ostream>
 #include <string_view>
 
@@ -177,6 +180,146 @@ inline bool utf8_grapheme_segmenter::iterator::operator!=(iterator const& other)
 }
 // }}}
 
+/// Segments UTF-8 text into grapheme clusters without copying or transcoding it.
+///
+/// Unlike utf8_grapheme_segmenter, which materializes every cluster as a std::u32string,
+/// the iterator yields each cluster as a std::string_view into the original UTF-8 text,
+/// keeping nothing but the decoder and the segmenter state. Invalid UTF-8 sequences are
+/// segmented as U+FFFD, but remain part of the yielded byte range.
+///
+/// With @p MeasureWidth set, the iterator additionally measures each cluster's display width
+/// (see grapheme_cluster_width()) in the same pass, sharing one property lookup per codepoint.
+template <bool MeasureWidth>
+class basic_utf8_grapheme_view
+{
+  public:
+    class iterator;
+
+    explicit basic_utf8_grapheme_view(std::string_view text) noexcept: _text { text } {}
+
+    iterator begin() const noexcept { return iterator { _text.data(), _text.data() + _text.size() }; }
+    iterator end() const noexcept { return iterator { _text.data() + _text.size(), _text.data() + _text.size() }; }
+
+  private:
+    std::string_view _text;
+};
+
+using utf8_grapheme_view = basic_utf8_grapheme_view<false>;
+using utf8_grapheme_width_view = basic_utf8_grapheme_view<true>;
+
+template <bool MeasureWidth>
+class basic_utf8_grapheme_view<MeasureWidth>::iterator
+{
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::string_view;
+
+    iterator() noexcept = default;
+    iterator(char const* data, char const* end) noexcept;
+
+    /// The current grapheme cluster as a byte range into the segmented text.
+    [[nodiscard]] std::string_view value() const noexcept
+    {
+        return { _clusterStart, static_cast<size_t>(_clusterEnd - _clusterStart) };
+    }
+
+    [[nodiscard]] std::string_view operator*() const noexcept { return value(); }
+
+    /// Display width, in columns, of the current grapheme cluster.
+    [[nodiscard]] unsigned width() const noexcept
+        requires MeasureWidth
+    {
+        return _width;
+    }
+
+    iterator& operator++() noexcept
+    {
+        consumeGraphemeCluster();
+        return *this;
+    }
+
+    iterator operator++(int) noexcept
+    {
+        auto tmp(*this);
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(iterator const& other) const noexcept { return _clusterStart == other._clusterStart; }
+    bool operator!=(iterator const& other) const noexcept { return !(*this == other); }
+
+  private:
+    void decodeCodepoint() noexcept;
+    void consumeGraphemeCluster() noexcept;
+
+    char const* _clusterStart = nullptr;
+    char const* _clusterEnd = nullptr;
+    char const* _nextCodepointStart = nullptr;
+    char const* _nextUtf8 = nullptr;
+    char const* _end = nullptr;
+    char32_t _nextCodepoint {};
+    codepoint_properties _nextProperties {};
+    grapheme_segmenter_state _segmenter_state {};
+    unsigned _width = 0;
+};
+
+// {{{ basic_utf8_grapheme_view::iterator implementation
+template <bool MeasureWidth>
+basic_utf8_grapheme_view<MeasureWidth>::iterator::iterator(char const* data, char const* end) noexcept:
+    _clusterStart { data }, _clusterEnd { data }, _nextCodepointStart { data }, _nextUtf8 { data }, _end { end }
+{
+    if (data != end)
+    {
+        decodeCodepoint();
+        consumeGraphemeCluster();
+    }
+}
+
+template <bool MeasureWidth>
+void basic_utf8_grapheme_view<MeasureWidth>::iterator::decodeCodepoint() noexcept
+{
+    _nextCodepointStart = _nextUtf8;
+    if (_nextUtf8 == _end)
+        return;
+
+    auto const [codepoint, length] = decode_utf8(std::string_view(_nextUtf8, static_cast<size_t>(_end - _nextUtf8)));
+    _nextUtf8 += length;
+    _nextCodepoint = codepoint;
+    _nextProperties = codepoint_properties::get(codepoint);
+}
+
+template <bool MeasureWidth>
+void basic_utf8_grapheme_view<MeasureWidth>::iterator::consumeGraphemeCluster() noexcept
+{
+    _clusterStart = _nextCodepointStart;
+    _clusterEnd = _nextCodepointStart;
+
+    if (_nextCodepointStart == _end)
+        return;
+
+    auto widthAccumulator = grapheme_cluster_width_accumulator {};
+
+    grapheme_process_init(_nextCodepoint, _nextProperties, _segmenter_state);
+    if constexpr (MeasureWidth)
+        widthAccumulator.push(_nextCodepoint, _nextProperties);
+    decodeCodepoint();
+
+    while (_nextCodepointStart != _end && !grapheme_process_breakable(_nextCodepoint, _nextProperties, _segmenter_state))
+    {
+        if constexpr (MeasureWidth)
+            widthAccumulator.push(_nextCodepoint, _nextProperties);
+        decodeCodepoint();
+    }
+
+    _clusterEnd = _nextCodepointStart;
+    if constexpr (MeasureWidth)
+        _width = widthAccumulator.width();
+}
+// }}}
+
 } // namespace unicode
 
 namespace std
@@ -16,7 +16,10 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <format>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -87,3 +90,52 @@ TEST_CASE("utf8_grapheme_segmenter.mixed")
     test_utf8_grapheme_cluster_segmentation(U"├"sv, U"─"sv, U" "sv, U"Y"sv, U"e"sv, U"s"sv);
     test_utf8_grapheme_cluster_segmentation(U"X"sv, U"\U0001F926\U0001F3FC\u200D\u2642\uFE0F"sv, U"5"sv);
 }
+
+TEST_CASE("utf8_grapheme_view.clusters")
+{
+    auto const text = "X\U0001F926\U0001F3FC\u200D\u2642\uFE0F\u0915\u094D\u0928 e\u0301\r\n"sv;
+    auto clusters = std::vector<std::string_view> {};
+    for (auto const cluster: unicode::utf8_grapheme_view(text))
+        clusters.push_back(cluster);
+
+    auto const expected = std::vector<std::string_view> {
+        "X"sv, "\U0001F926\U0001F3FC\u200D\u2642\uFE0F"sv, "\u0915\u094D\u0928"sv, " "sv, "e\u0301"sv, "\r\n"sv,
+    };
+    REQUIRE(clusters == expected);
+
+    // The clusters are views into the segmented text, without gaps between them.
+    CHECK(clusters.front().data() == text.data());
+    for (size_t i = 1; i < clusters.size(); ++i)
+        CHECK(clusters[i].data() == clusters[i - 1].data() + clusters[i - 1].size());
+
+    CHECK(unicode::utf8_grapheme_view(""sv).begin() == unicode::utf8_grapheme_view(""sv).end());
+}
+
+TEST_CASE("utf8_grapheme_view.invalid")
+{
+    // An invalid byte is its own (U+FFFD) cluster, and a lead byte cutting a sequence short
+    // still begins the codepoint it leads.
+    auto const text = "a\x80" "b\xC3\xE2\x82\xAC"sv;
+    auto clusters = std::vector<std::string_view> {};
+    for (auto const cluster: unicode::utf8_grapheme_view(text))
+        clusters.push_back(cluster);
+    CHECK(clusters == std::vector<std::string_view> { "a"sv, "\x80"sv, "b"sv, "\xC3"sv, "\xE2\x82\xAC"sv });
+}
+
+TEST_CASE("utf8_grapheme_view.width")
+{
+    auto const text = "a\u0915\u093E\U0001F600\u2714\uFE0F\u2764\u200D\U0001F525"sv;
+    auto clusters = std::vector<std::pair<std::string_view, unsigned>> {};
+    auto const view = unicode::utf8_grapheme_width_view(text);
+    for (auto i = view.begin(); i != view.end(); ++i)
+        clusters.emplace_back(*i, i.width());
+
+    auto const expected = std::vector<std::pair<std::string_view, unsigned>> {
+        { "a"sv, 1 },
+        { "\u0915\u093E"sv, 2 },
+        { "\U0001F600"sv, 2 },
+        { "\u2714\uFE0F"sv, 2 },
+        { "\u2764\u200D\U0001F525"sv, 1 },
+    };
+    CHECK(clusters == expected);
+}
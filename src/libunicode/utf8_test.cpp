@@ -216,6 +216,24 @@ TEST_CASE("utf8.from_utf8.incomplete.4", "[utf8]")
     REQUIRE(get<Success>(last).value == codepoint);
 }
 
+TEST_CASE("utf8.decode_utf8", "[utf8]")
+{
+    auto const check = [](string_view text, char32_t codepoint, size_t length) {
+        CAPTURE(text);
+        auto const result = decode_utf8(text);
+        CHECK(result.codepoint == codepoint);
+        CHECK(result.length == length);
+    };
+
+    check("a\xC3"sv, 'a', 1);
+    check("\xE2\x82\xAC!"sv, U'\u20AC', 3);
+    check("\xF0\x9F\x98\x80"sv, U'\U0001F600', 4);
+
+    check("\x80\xC3\xB6"sv, U'\uFFFD', 1);     // stray continuation byte
+    check("\xE2\x82"sv, U'\uFFFD', 2);          // truncated by the end of the text
+    check("\xE2\x82\xC3\xB6"sv, U'\uFFFD', 2); // cut short by the lead byte of the next codepoint
+}
+
 TEST_CASE("utf8.iter", "[utf8]")
 {
     auto constexpr values = string_view {
@@ -11,12 +11,18 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <libunicode/cluster_walker.h>
 #include <libunicode/codepoint_properties.h>
-#include <libunicode/convert.h>
 #include <libunicode/grapheme_segmenter.h>
+#include <libunicode/scan.h>
+#include <libunicode/support.h>
 #include <libunicode/ucd.h>
+#include <libunicode/utf8.h>
 #include <libunicode/width.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <string>
 #include <string_view>
 
@@ -31,17 +37,63 @@ unsigned width(char32_t codepoint) noexcept
 namespace
 {
     /// wcwidth's _EMOJI_ZWJ_SET: every Extended_Pictographic plus the 26 regional indicators.
-    bool joinsEmojiSequence(char32_t codepoint) noexcept
+    bool joinsEmojiSequence(codepoint_properties const& props) noexcept
     {
-        auto const props = codepoint_properties::get(codepoint);
         return props.is_extended_pictographic() || props.grapheme_cluster_break == Grapheme_Cluster_Break::Regional_Indicator;
     }
+
+    /// Direct-mapped cache of grapheme cluster widths, one per thread.
+    ///
+    /// A slot holds the cluster's codepoints, so a hash collision is told apart from a hit, and is
+    /// simply overwritten by the next cluster mapping to it.
+    class cluster_width_cache
+    {
+      public:
+        static constexpr size_t MinClusterSize = 2;
+        static constexpr size_t MaxClusterSize = 12;
+
+        /// Returns the cached width of @p cluster, computing and caching it if necessary.
+        template <typename Compute>
+        unsigned get(std::u32string_view cluster, Compute compute) noexcept
+        {
+            auto hasher = codepoint_hasher {};
+            for (auto const codepoint: cluster)
+                hasher(codepoint);
+            auto const hash = hasher.value();
+
+            auto& slot = _slots[hash % SlotCount];
+            if (slot.hash == hash && slot.length == cluster.size()
+                && std::equal(cluster.begin(), cluster.end(), slot.codepoints.begin()))
+                return slot.width;
+
+            slot.hash = hash;
+            slot.length = static_cast<uint8_t>(cluster.size());
+            slot.width = compute();
+            std::copy(cluster.begin(), cluster.end(), slot.codepoints.begin());
+            return slot.width;
+        }
+
+      private:
+        static constexpr size_t SlotCount = 512;
+
+        // One cache line per slot.
+        struct alignas(64) slot_type
+        {
+            uint64_t hash = 0;
+            uint8_t length = 0; // 0 marks an unused slot, as no cached cluster is empty
+            unsigned width = 0;
+            std::array<char32_t, MaxClusterSize> codepoints {};
+        };
+        static_assert(sizeof(slot_type) == 64);
+
+        std::array<slot_type, SlotCount> _slots {};
+    };
+
+    std::atomic<bool> clusterWidthCacheEnabled = false; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 } // namespace
 
-void grapheme_cluster_width_accumulator::push(char32_t codepoint) noexcept
+void grapheme_cluster_width_accumulator::push(char32_t codepoint, codepoint_properties const& properties) noexcept
 {
-    auto const properties = codepoint_properties::get(codepoint);
-
     // A flag is a PAIR of regional indicators rendered as one glyph, and which half this codepoint is
     // depends on how many regional indicators sit *immediately* before it. That run length is
     // therefore maintained for every codepoint, including the ones the branches below return early
@@ -82,7 +134,7 @@ void grapheme_cluster_width_accumulator::push(char32_t codepoint) noexcept
         // zeroes the latter, and wcwidth resolves VS16 purely by looking the base up in its
         // narrow-to-wide table without consulting it. That table is encoded here as the variation
         // base flag plus a base width of one.
-        if (auto const base = codepoint_properties::get(_lastMeasured); base.is_emoji_variation_base() && base.char_width == 1)
+        if (_lastMeasured.is_emoji_variation_base() && _lastMeasured.char_width == 1)
             _current = 2;
         _lastMeasuredIsOpen = false; // prevent a second application
         return;
@@ -98,7 +150,7 @@ void grapheme_cluster_width_accumulator::push(char32_t codepoint) noexcept
     // zero). Both are pinned by tests; see repeated_vs15_underflows_like_wcwidth.
     if (codepoint == 0xFE0E && _lastMeasuredIsOpen)
     {
-        if (codepoint_properties::get(_lastMeasured).is_emoji_variation_base() && _lastMeasuredWidth == 2)
+        if (_lastMeasured.is_emoji_variation_base() && _lastMeasuredWidth == 2)
             --_total;
         return;
     }
@@ -106,7 +158,7 @@ void grapheme_cluster_width_accumulator::push(char32_t codepoint) noexcept
     // The second indicator of a pair is drawn into the flag the first one opened, so it adds nothing.
     if (properties.grapheme_cluster_break == Grapheme_Cluster_Break::Regional_Indicator && regionalIndicatorsBefore % 2 == 1)
     {
-        _lastMeasured = codepoint;
+        _lastMeasured = properties;
         return;
     }
 
@@ -130,7 +182,7 @@ void grapheme_cluster_width_accumulator::push(char32_t codepoint) noexcept
         else
             _current = w;
 
-        _lastMeasured = codepoint;
+        _lastMeasured = properties;
         _lastMeasuredWidth = w;
         _lastMeasuredIsOpen = true;
         _previousWasVirama = false;
@@ -162,27 +214,141 @@ unsigned grapheme_cluster_width(std::u32string_view cluster) noexcept
     if (cluster.size() == 1)
         return width(cluster[0]);
 
-    auto accumulator = grapheme_cluster_width_accumulator {};
-    for (auto const codepoint: cluster)
-        accumulator.push(codepoint);
-    return accumulator.width();
+    auto const measure = [cluster]() noexcept {
+        auto accumulator = grapheme_cluster_width_accumulator {};
+        for (auto const codepoint: cluster)
+            accumulator.push(codepoint);
+        return accumulator.width();
+    };
+
+    if (cluster.size() < cluster_width_cache::MinClusterSize || cluster.size() > cluster_width_cache::MaxClusterSize
+        || !clusterWidthCacheEnabled.load(std::memory_order_relaxed))
+        return measure();
+
+    thread_local auto cache = cluster_width_cache {};
+    return cache.get(cluster, measure);
+}
+
+void enable_grapheme_cluster_width_cache(bool enabled) noexcept
+{
+    clusterWidthCacheEnabled.store(enabled, std::memory_order_relaxed);
 }
 
 unsigned grapheme_cluster_width(std::string_view utf8Text) noexcept
 {
-    auto const u32 = convert_to<char32_t>(utf8Text);
-    if (u32.empty())
-        return 0;
+    return detail::measure_utf8_text(utf8Text, false).width;
+}
+
+column_offset find_column_offset(std::string_view utf8Text, size_t column) noexcept
+{
+    auto result = column_offset { utf8Text.size(), 0 };
+    auto const found = detail::walk_clusters(
+        utf8Text,
+        [&](size_t start, size_t /*end*/, size_t clusterColumn, size_t width) noexcept {
+            result.column = clusterColumn + width;
+            if (column >= clusterColumn + width)
+                return false;
+            result = { start, clusterColumn };
+            return true;
+        },
+        [&](size_t start, size_t count, size_t runColumn) noexcept {
+            result.column = runColumn + count;
+            if (column >= runColumn + count)
+                return false;
+            result = { start + (column - runColumn), column };
+            return true;
+        });
+    if (!found)
+        result.offset = utf8Text.size();
+    return result;
+}
+
+size_t column_of_offset(std::string_view utf8Text, size_t offset) noexcept
+{
+    auto result = size_t { 0 };
+    detail::walk_clusters(
+        utf8Text,
+        [&](size_t /*start*/, size_t end, size_t clusterColumn, size_t width) noexcept {
+            result = offset < end ? clusterColumn : clusterColumn + width;
+            return offset < end;
+        },
+        [&](size_t start, size_t count, size_t runColumn) noexcept {
+            result = offset < start + count ? runColumn + (offset - start) : runColumn + count;
+            return offset < start + count;
+        });
+    return result;
+}
+
+detail::utf8_text_metrics detail::measure_utf8_text(std::string_view utf8Text, bool baseWidthOnly) noexcept
+{
+    // A single pass over the UTF-8 text, segmenting and measuring as it decodes.
+    //
+    // Runs of printable US-ASCII are skipped in bulk: each of those characters is one column wide and
+    // a grapheme cluster of its own, except that the first may still join the cluster before it (GB9b)
+    // and the last may be the base of a cluster continuing after the run.
+    auto metrics = utf8_text_metrics {};
+    auto segmenterState = grapheme_segmenter_state {};
+    auto cluster = grapheme_cluster_width_accumulator {};
+    auto isFirstCodepoint = true;
+
+    auto const beginCluster = [&](codepoint_properties const& properties) noexcept {
+        ++metrics.clusterCount;
+        if (baseWidthOnly)
+            metrics.width += properties.char_width;
+        else
+        {
+            metrics.width += cluster.width();
+            cluster.reset();
+        }
+    };
 
-    auto totalWidth = 0u;
-    auto segmenter = grapheme_segmenter(std::u32string_view(u32));
-    totalWidth += grapheme_cluster_width(*segmenter);
-    while (segmenter.codepointsAvailable())
+    auto const feed = [&](char32_t codepoint) noexcept {
+        auto const properties = codepoint_properties::get(codepoint);
+        if (isFirstCodepoint)
+        {
+            grapheme_process_init(codepoint, properties, segmenterState);
+            beginCluster(properties);
+            isFirstCodepoint = false;
+        }
+        else if (grapheme_process_breakable(codepoint, properties, segmenterState))
+            beginCluster(properties);
+        if (!baseWidthOnly)
+            cluster.push(codepoint, properties);
+    };
+
+    auto input = utf8Text.data();
+    auto const end = utf8Text.data() + utf8Text.size();
+    while (input != end)
     {
-        ++segmenter;
-        totalWidth += grapheme_cluster_width(*segmenter);
+        if (auto const asciiRun = detail::printable_ascii_prefix(std::string_view(input, static_cast<size_t>(end - input)));
+            asciiRun > 2)
+        {
+            feed(static_cast<char32_t>(*input));
+
+            metrics.clusterCount += asciiRun - 2;
+            metrics.width += static_cast<unsigned>(asciiRun - 2);
+
+            auto const last = static_cast<char32_t>(input[asciiRun - 1]);
+            auto const properties = codepoint_properties::get(last);
+            grapheme_process_init(last, properties, segmenterState);
+            beginCluster(properties);
+            if (!baseWidthOnly)
+                cluster.push(last, properties);
+
+            input += asciiRun;
+            continue;
+        }
+
+        // Invalid or truncated sequences are measured as U+FFFD.
+        auto const [codepoint, length] = decode_utf8(std::string_view(input, static_cast<size_t>(end - input)));
+        input += length;
+        feed(codepoint);
     }
-    return totalWidth;
+
+    if (!baseWidthOnly)
+        metrics.width += cluster.width();
+
+    return metrics;
 }
 
 } // namespace unicode
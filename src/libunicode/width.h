@@ -13,6 +13,9 @@
  */
 #pragma once
 
+#include <libunicode/codepoint_properties.h>
+
+#include <cstddef>
 #include <string_view>
 
 namespace unicode
@@ -34,7 +37,11 @@ class grapheme_cluster_width_accumulator
 {
   public:
     /// Feeds the next codepoint of the current grapheme cluster.
-    void push(char32_t codepoint) noexcept;
+    void push(char32_t codepoint) noexcept { push(codepoint, codepoint_properties::get(codepoint)); }
+
+    /// Feeds the next codepoint of the current grapheme cluster along with its already looked up
+    /// @p properties, so that a caller that also segments the text needs only one lookup per codepoint.
+    void push(char32_t codepoint, codepoint_properties const& properties) noexcept;
 
     /// Width, in columns, of everything pushed since construction or the last reset().
     [[nodiscard]] unsigned width() const noexcept;
@@ -47,7 +54,8 @@ class grapheme_cluster_width_accumulator
     // is not always the one just before it: zero-width members are stepped over, and a selector that
     // has already been applied must not apply a second time. Tracking that codepoint, its width, and
     // whether it is still open to modification is what keeps this in step with wcwidth.
-    char32_t _lastMeasured = 0;
+    // Its properties are kept rather than the codepoint itself, so nothing needs looking up again.
+    codepoint_properties _lastMeasured {};
     int _lastMeasuredWidth = 0;
     bool _lastMeasuredIsOpen = false; // false blocks VS15/VS16: nothing to re-present
 
@@ -97,13 +105,64 @@ class grapheme_cluster_width_accumulator
 /// @return the display column width of the grapheme cluster.
 unsigned grapheme_cluster_width(std::u32string_view graphemeCluster) noexcept;
 
+/// Enables or disables memoizing grapheme_cluster_width() for clusters of 2 to 12 codepoints.
+///
+/// Text such as chat logs repeats the same few hundred emoji ZWJ, variation and modifier sequences
+/// (e.g. U+2764 U+FE0F, or U+1F44D U+1F3FD) over and over, and each of them otherwise costs a
+/// property lookup per codepoint every time.
+/// With the cache enabled, their widths are kept in a small fixed-size table per thread, so it
+/// needs no locking and never grows. The cache is disabled by default.
+void enable_grapheme_cluster_width_cache(bool enabled) noexcept;
+
 /// Computes the total display width of a UTF-8 encoded string.
 ///
 /// Performs grapheme cluster segmentation internally,
 /// then sums up the width of each grapheme cluster.
 ///
+/// The text is measured in a single pass as it is decoded, without allocating.
+/// Invalid UTF-8 sequences are measured as U+FFFD.
+///
 /// @param utf8Text the UTF-8 encoded text.
 /// @return the total display column width.
 unsigned grapheme_cluster_width(std::string_view utf8Text) noexcept;
 
+/// Location of a grapheme cluster within a UTF-8 encoded line of text.
+struct column_offset
+{
+    /// Byte offset of the grapheme cluster's first codepoint.
+    size_t offset;
+
+    /// Column the grapheme cluster starts at.
+    size_t column;
+};
+
+/// Finds the grapheme cluster of a UTF-8 encoded line of text that occupies the given @p column.
+///
+/// Columns are counted from zero and measured as grapheme_cluster_width() does. A wide cluster
+/// occupies all of its columns, so asking for its second column yields the cluster's start,
+/// and the column it starts at is returned along with it.
+///
+/// @return the cluster's start, or the end of the text and its width if the text is not that wide.
+column_offset find_column_offset(std::string_view utf8Text, size_t column) noexcept;
+
+/// Returns the column at which the grapheme cluster that contains byte @p offset starts,
+/// or the width of @p utf8Text if @p offset is at or past its end.
+size_t column_of_offset(std::string_view utf8Text, size_t offset) noexcept;
+
+namespace detail
+{
+    /// Number of grapheme clusters in, and display width of, a UTF-8 encoded text.
+    struct utf8_text_metrics
+    {
+        size_t clusterCount = 0;
+        unsigned width = 0;
+    };
+
+    /// Segments and measures UTF-8 text in a single pass, without allocating.
+    ///
+    /// With @p baseWidthOnly set, every grapheme cluster is measured by its base codepoint alone
+    /// (see GC_WIDTH_MODE_NON_MODIFIABLE in the C API), otherwise as grapheme_cluster_width() does.
+    utf8_text_metrics measure_utf8_text(std::string_view utf8Text, bool baseWidthOnly) noexcept;
+} // namespace detail
+
 } // namespace unicode
@@ -378,3 +378,109 @@ TEST_CASE("grapheme_cluster_width.utf8_string", "[width]")
     // "A☝️" = 'A' (width 1) + U+261D U+FE0F (width 2) = 3
     CHECK(unicode::grapheme_cluster_width("A\xe2\x98\x9d\xef\xb8\x8f"sv) == 3);
 }
+
+TEST_CASE("grapheme_cluster_width.utf8_ascii_runs", "[width]")
+{
+    // A run of printable ASCII is counted in bulk, but its ends still join their neighbours:
+    // the first character follows a Prepend (U+0600), the last carries a combining mark.
+    CHECK(unicode::grapheme_cluster_width("\u0600abcdef"sv) == 1 + 6);
+    CHECK(unicode::grapheme_cluster_width("\u0600abcdef"sv) == unicode::grapheme_cluster_width(U"\u0600a"sv) + 5);
+    CHECK(unicode::grapheme_cluster_width("abcdef\u0301ghi"sv) == 9);
+    CHECK(unicode::grapheme_cluster_width("ab\x7F" "cdef\tgh"sv) == 8);
+}
+
+TEST_CASE("grapheme_cluster_width.utf8_invalid", "[width]")
+{
+    CHECK(unicode::grapheme_cluster_width("a\x80" "b"sv) == 3);
+    CHECK(unicode::grapheme_cluster_width("a\xC3"sv) == 2);
+    CHECK(unicode::grapheme_cluster_width("\xC3\xE4\xB8\xAD"sv) == 3); // truncated + 中
+}
+
+TEST_CASE("grapheme_cluster_width.cache", "[width]")
+{
+    auto const clusters = std::array {
+        U"\U0001F468\u200D\U0001F469\u200D\U0001F467"sv, // family, ZWJ sequence
+        U"\U0001F44D\U0001F3FD"sv, // thumbs up, skin tone
+        U"\u2764\uFE0F"sv, // heart, VS16
+        U"#\uFE0F\u20E3"sv, // keycap
+        U"\u2764\u200D\U0001F525"sv, // heart on fire, no VS16
+        U"\U0001F3F4\U000E0067\U000E0062\U000E0073\U000E0063\U000E0074\U000E007F"sv, // Scotland
+        U"\u0915\u094D\u0928"sv, // conjunct
+        U"e\u0301\u0302\u0303"sv, // combining stack
+        U"\u1100\u1100\u1100\u1100\u1100\u1100\u1100\u1100\u1100\u1100\u1100\u1100\u1100"sv, // too long to cache
+    };
+
+    auto expected = std::array<unsigned, clusters.size()> {};
+    for (size_t i = 0; i < clusters.size(); ++i)
+        expected[i] = unicode::grapheme_cluster_width(clusters[i]);
+
+    // Cached widths, whether just computed or hit, equal the measured ones.
+    unicode::enable_grapheme_cluster_width_cache(true);
+    for (auto round = 0; round < 2; ++round)
+        for (size_t i = 0; i < clusters.size(); ++i)
+            CHECK(unicode::grapheme_cluster_width(clusters[i]) == expected[i]);
+    unicode::enable_grapheme_cluster_width_cache(false);
+
+    CHECK(expected[2] == 2);
+    CHECK(expected[4] == 1);
+    CHECK(expected[8] == 26);
+}
+
+TEST_CASE("find_column_offset.wide_cluster", "[width]")
+{
+    auto const text = "ab\u4E2Dcd"sv; // 中 occupies columns 2 and 3, bytes 2..4
+    CHECK(unicode::find_column_offset(text, 0).offset == 0);
+    CHECK(unicode::find_column_offset(text, 2).offset == 2);
+    CHECK(unicode::find_column_offset(text, 3).offset == 2);
+    CHECK(unicode::find_column_offset(text, 3).column == 2);
+    CHECK(unicode::find_column_offset(text, 4).offset == 5);
+    CHECK(unicode::find_column_offset(text, 5).offset == 6);
+    CHECK(unicode::find_column_offset(text, 6).offset == 7);
+    CHECK(unicode::find_column_offset(text, 80).column == 6);
+
+    CHECK(unicode::column_of_offset(text, 0) == 0);
+    CHECK(unicode::column_of_offset(text, 3) == 2);
+    CHECK(unicode::column_of_offset(text, 5) == 4);
+    CHECK(unicode::column_of_offset(text, 7) == 6);
+    CHECK(unicode::column_of_offset(text, 80) == 6);
+}
+
+TEST_CASE("find_column_offset.ascii_runs", "[width]")
+{
+    // The combining acute accent (bytes 6..7) belongs to the cluster of the 'f' before it.
+    auto const text = "abcdef\u0301ghij"sv;
+    CHECK(unicode::find_column_offset(text, 3).offset == 3);
+    CHECK(unicode::find_column_offset(text, 5).offset == 5);
+    CHECK(unicode::find_column_offset(text, 6).offset == 8);
+    CHECK(unicode::column_of_offset(text, 6) == 5);
+    CHECK(unicode::column_of_offset(text, 9) == 7);
+
+    CHECK(unicode::find_column_offset(""sv, 0).offset == 0);
+    CHECK(unicode::column_of_offset(""sv, 0) == 0);
+}
+
+TEST_CASE("find_column_offset.agrees_with_column_of_offset", "[width]")
+{
+    auto const texts = std::array {
+        "\u0600abcdef \U0001F468\u200D\U0001F469\u200D\U0001F467 xyz"sv,
+        "\u0915\u094D\u0928 \u2764\uFE0F\U0001F1E9\U0001F1EA#\uFE0F\u20E3 tail"sv,
+        "a\x80" "bc\xC3\xE4\xB8\xAD" "defgh\uAC01"sv,
+    };
+
+    for (auto const text: texts)
+    {
+        auto const width = static_cast<size_t>(unicode::grapheme_cluster_width(text));
+        CHECK(unicode::find_column_offset(text, width).offset == text.size());
+        CHECK(unicode::find_column_offset(text, width).column == width);
+
+        for (size_t column = 0; column < width; ++column)
+        {
+            INFO("column: " << column);
+            auto const found = unicode::find_column_offset(text, column);
+            CHECK(found.column <= column);
+            CHECK(found.offset < text.size());
+            CHECK(unicode::column_of_offset(text, found.offset) == found.column);
+            CHECK(unicode::grapheme_cluster_width(text.substr(0, found.offset)) == found.column);
+        }
+    }
+}